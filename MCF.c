@@ -9,7 +9,9 @@
  */
 
 #include "MCF.h"
+#include "MCF_trace.h"
 #include "assert.h"
+#include <stdatomic.h>
 #include <stddef.h>
 
 /**
@@ -98,6 +100,8 @@ void MCF_send_u16(MCF_t *Instance, uint16_t msgID, uint16_t value)
 
     Instance->msgBuf[head].u16 = value;
     Instance->msgBuf[head].msgID = msgID;
+    MCF_TRACE_SEND(Instance, head, msgID);
+    MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
     *(Instance->head) = head;
 }
 
@@ -128,6 +132,8 @@ void MCF_send_i16(MCF_t *Instance, uint16_t msgID, int16_t value)
 
     Instance->msgBuf[head].i16 = value;
     Instance->msgBuf[head].msgID = msgID;
+    MCF_TRACE_SEND(Instance, head, msgID);
+    MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
     *(Instance->head) = head;
 }
 
@@ -158,6 +164,8 @@ void MCF_send_u32(MCF_t *Instance, uint16_t msgID, uint32_t value)
 
     Instance->msgBuf[head].u32 = value;
     Instance->msgBuf[head].msgID = msgID;
+    MCF_TRACE_SEND(Instance, head, msgID);
+    MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
     *(Instance->head) = head;
 }
 
@@ -188,6 +196,8 @@ void MCF_send_i32(MCF_t *Instance, uint16_t msgID, int32_t value)
 
     Instance->msgBuf[head].i32 = value;
     Instance->msgBuf[head].msgID = msgID;
+    MCF_TRACE_SEND(Instance, head, msgID);
+    MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
     *(Instance->head) = head;
 }
 
@@ -218,6 +228,8 @@ void MCF_send_f32(MCF_t *Instance, uint16_t msgID, float value)
 
     Instance->msgBuf[head].f32 = value;
     Instance->msgBuf[head].msgID = msgID;
+    MCF_TRACE_SEND(Instance, head, msgID);
+    MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
     *(Instance->head) = head;
 }
 
@@ -228,21 +240,173 @@ void MCF_send_f32(MCF_t *Instance, uint16_t msgID, float value)
  * passes it to the parser function defined in the MCF instance.
  *
  * This function must only be called if the `msgParser` callback is set.
- * Should be invoked regularly in the application main loop.
+ * Should be invoked regularly in the application main loop. Parses at most
+ * `UINT16_MAX` messages per call, so a producer refilling the ring cannot keep
+ * it looping forever.
  *
  * @param Instance Pointer to the MCF instance.
  */
 void MCF_receive(MCF_t *Instance)
+{
+    (void)MCF_receive_n(Instance, UINT16_MAX);
+}
+
+/**
+ * @brief Receives and parses up to `maxMessages` messages from the buffer.
+ *
+ * Bounded variant of `MCF_receive()`.
+ *
+ * @param Instance    Pointer to the MCF instance.
+ * @param maxMessages Maximum number of messages to parse.
+ * @return Number of messages parsed.
+ */
+uint16_t MCF_receive_n(MCF_t *Instance, uint16_t maxMessages)
 {
     assert(Instance != NULL);
 
-    while (*(Instance->head) != *(Instance->tail))
+    uint16_t received = 0;
+
+    while ((received < maxMessages) && (*(Instance->head) != *(Instance->tail)))
     {
+        MCF_CHAOS_POINT(MCF_CHAOS_RECEIVE_ADVANCE);
         (*(Instance->tail))++;
+        MCF_CHAOS_POINT(MCF_CHAOS_RECEIVE_WRAP);
         if (*(Instance->tail) >= Instance->msgBufSize)
         {
             *(Instance->tail) = 0;
         }
+        MCF_CHAOS_POINT(MCF_CHAOS_RECEIVE_PARSE);
+        MCF_TRACE_RECEIVE(Instance, Instance->msgBuf[*(Instance->tail)].msgID);
         Instance->msgParser(&(Instance->msgBuf[*(Instance->tail)]));
+        received++;
+    }
+
+    MCF_TRACE_RECEIVE_BATCH(Instance, received);
+    return received;
+}
+
+/**
+ * @brief Sends a batch of messages with a single head update.
+ *
+ * Copies as many messages as there are free slots, then publishes the new head.
+ *
+ * @param Instance Pointer to the MCF instance.
+ * @param Msgs     Messages to send.
+ * @param count    Number of messages in `Msgs`.
+ * @return Number of messages sent.
+ */
+uint16_t MCF_send_batch(MCF_t *Instance, const MCF_Message_t *Msgs, uint16_t count)
+{
+    assert((Instance != NULL) && ((Msgs != NULL) || (0 == count)));
+
+    uint16_t room = MCF_get_free(Instance);
+    uint16_t head = *(Instance->head);
+
+    if (count > room)
+    {
+        count = room;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (head >= Instance->msgBufSize - 1)
+        {
+            head = 0;
+        }
+        else
+        {
+            head++;
+        }
+        Instance->msgBuf[head] = Msgs[i];
+        MCF_TRACE_SEND(Instance, head, Msgs[i].msgID);
+    }
+
+    if (0 < count)
+    {
+        MCF_CHAOS_POINT(MCF_CHAOS_SEND_PUBLISH);
+        atomic_thread_fence(memory_order_release);
+        *(Instance->head) = head;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns a contiguous span of pending messages without consuming them.
+ *
+ * @param Instance Pointer to the MCF instance.
+ * @param offset   Pending messages to skip.
+ * @param Span     Receives the first message of the span.
+ * @return Number of messages in the span.
+ */
+uint16_t MCF_peek(const MCF_t *Instance, uint16_t offset, MCF_Message_t **Span)
+{
+    assert((Instance != NULL) && (Span != NULL));
+
+    uint16_t pending = MCF_get_pending(Instance);
+
+    if (pending <= offset)
+    {
+        return 0;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    /* The tail slot holds the last consumed message; the span starts after it. */
+    uint32_t first = (uint32_t)*(Instance->tail) + 1u + offset;
+    uint16_t count = (uint16_t)(pending - offset);
+
+    first %= Instance->msgBufSize;
+    if (count > Instance->msgBufSize - first)
+    {
+        count = (uint16_t)(Instance->msgBufSize - first);
     }
+    *Span = &Instance->msgBuf[first];
+    return count;
+}
+
+/**
+ * @brief Consumes the oldest pending messages without parsing them.
+ *
+ * @param Instance Pointer to the MCF instance.
+ * @param count    Number of messages to consume.
+ */
+void MCF_release(MCF_t *Instance, uint16_t count)
+{
+    assert((Instance != NULL) && (count <= MCF_get_pending(Instance)));
+
+    uint32_t tail = ((uint32_t)*(Instance->tail) + count) % Instance->msgBufSize;
+
+    atomic_thread_fence(memory_order_release);
+    *(Instance->tail) = (uint16_t)tail;
+    MCF_TRACE_RECEIVE_BATCH(Instance, count);
+}
+
+/**
+ * @brief Returns the number of messages waiting in the buffer.
+ *
+ * @param Instance Pointer to the MCF instance.
+ */
+uint16_t MCF_get_pending(const MCF_t *Instance)
+{
+    assert(Instance != NULL);
+
+    uint16_t head = *(Instance->head);
+    uint16_t tail = *(Instance->tail);
+
+    if (head >= tail)
+    {
+        return (uint16_t)(head - tail);
+    }
+    return (uint16_t)(Instance->msgBufSize - tail + head);
+}
+
+/**
+ * @brief Returns the number of free slots in the buffer.
+ *
+ * @param Instance Pointer to the MCF instance.
+ */
+uint16_t MCF_get_free(const MCF_t *Instance)
+{
+    assert(Instance != NULL);
+
+    return (uint16_t)(Instance->msgBufSize - 1u - MCF_get_pending(Instance));
 }
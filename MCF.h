@@ -13,6 +13,15 @@
 
 #include <stdint.h>
 
+/**
+ * @brief Cache line size used to keep indices written by different cores apart.
+ *
+ * Override from the build (e.g. 32 on Cortex-M7) to match the target.
+ */
+#ifndef MCF_CACHE_LINE_SIZE
+#define MCF_CACHE_LINE_SIZE 64
+#endif
+
 /**
  * @brief Message structure used in the MCF inter-core ring buffer.
  *
@@ -61,6 +70,19 @@ typedef struct
     void (*msgParser)(MCF_Message_t *msgBuf);
 } MCF_t;
 
+/**
+ * @brief Head and tail indices placed on separate cache lines.
+ *
+ * Optional storage for the `head` and `tail` pointers of an `MCF_t`, so that the
+ * producer and the consumer each write only a line they own. Used by the
+ * multi-lane channels, where many rings are polled by one consumer.
+ */
+typedef struct
+{
+    _Alignas(MCF_CACHE_LINE_SIZE) uint16_t head;
+    _Alignas(MCF_CACHE_LINE_SIZE) uint16_t tail;
+} MCF_Indices_t;
+
 /**
  * @brief Initializes the MCF instance for transmission (TX) only.
  *
@@ -184,4 +206,75 @@ void MCF_send_f32(MCF_t *Instance, uint16_t msgID, float value);
  */
 void MCF_receive(MCF_t *Instance);
 
+/**
+ * @brief Receives and parses at most `maxMessages` messages from the MCF queue.
+ *
+ * Same as `MCF_receive()`, but stops after `maxMessages` so the caller can bound
+ * the time spent on one queue (e.g. when servicing several queues by priority).
+ *
+ * @param Instance    Pointer to the MCF queue instance.
+ * @param maxMessages Maximum number of messages to parse.
+ * @return Number of messages parsed.
+ */
+uint16_t MCF_receive_n(MCF_t *Instance, uint16_t maxMessages);
+
+/**
+ * @brief Sends up to `count` messages and publishes them with one head update.
+ *
+ * Unlike `MCF_send_*`, a batch never overwrites unread messages: only as many
+ * messages as there are free slots are sent. The consumer sees the whole batch
+ * at once, and the shared head line is written once per batch.
+ *
+ * @param Instance Pointer to the MCF queue instance.
+ * @param Msgs     Messages to send.
+ * @param count    Number of messages in `Msgs`.
+ * @return Number of messages sent (the first ones of `Msgs`).
+ */
+uint16_t MCF_send_batch(MCF_t *Instance, const MCF_Message_t *Msgs, uint16_t count);
+
+/**
+ * @brief Returns a contiguous span of pending messages without consuming them.
+ *
+ * Lets the consumer hand messages to an API that takes a buffer (socket,
+ * file, DMA) straight from the ring. The span starts `offset` messages after
+ * the oldest pending one and ends at the newest message or at the end of the
+ * buffer, whichever comes first; peek again with a larger offset for the part
+ * after the wrap. The slots stay valid until `MCF_release()` frees them.
+ *
+ * @param Instance Pointer to the MCF queue instance.
+ * @param offset   Pending messages to skip (e.g. spans already handed out).
+ * @param Span     Receives the first message of the span.
+ * @return Number of messages in the span, 0 if fewer than `offset + 1` are pending.
+ */
+uint16_t MCF_peek(const MCF_t *Instance, uint16_t offset, MCF_Message_t **Span);
+
+/**
+ * @brief Consumes the `count` oldest pending messages without parsing them.
+ *
+ * Completes `MCF_peek()`: the tail is advanced and published once.
+ *
+ * @param Instance Pointer to the MCF queue instance.
+ * @param count    Number of messages to consume (at most the pending count).
+ */
+void MCF_release(MCF_t *Instance, uint16_t count);
+
+/**
+ * @brief Returns the number of messages waiting in the MCF queue.
+ *
+ * @param Instance Pointer to the MCF queue instance.
+ * @return Messages sent but not yet received.
+ */
+uint16_t MCF_get_pending(const MCF_t *Instance);
+
+/**
+ * @brief Returns how many messages can be sent without overwriting unread ones.
+ *
+ * `MCF_send_*` never refuses a message; a producer that must not lose data checks
+ * this before sending. The ring holds at most `msgBufSize - 1` messages.
+ *
+ * @param Instance Pointer to the MCF queue instance.
+ * @return Free slots in the circular buffer.
+ */
+uint16_t MCF_get_free(const MCF_t *Instance);
+
 #endif /* MULTICORE_FIFO_MCF_H_ */
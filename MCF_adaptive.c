@@ -0,0 +1,157 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_adaptive.h"
+#include "assert.h"
+#include <stddef.h>
+
+/** Fraction bits of `cost`. */
+#define MCF_ADAPTIVE_COST_SHIFT 4u
+
+/** Weight of a new cost sample: 1/2^shift. */
+#define MCF_ADAPTIVE_EWMA_SHIFT 3u
+
+/** Share of the free space the unpublished tail may hide from the producer: 1/2^shift. */
+#define MCF_ADAPTIVE_FREE_SHIFT 2u
+
+/** Minimum number of tail publishes per `targetLatency` of parsing: 2^shift. */
+#define MCF_ADAPTIVE_PUBLISH_SHIFT 2u
+
+static inline uint16_t MCF_adaptive_clamp(uint32_t value, uint16_t min, uint16_t max)
+{
+    if (value < min)
+    {
+        return min;
+    }
+    return (value > max) ? max : (uint16_t)value;
+}
+
+/**
+ * @brief Folds the cost of the last batch into the estimate and derives the next batch limit.
+ */
+static void MCF_adaptive_tune(MCF_Adaptive_t *Instance, uint32_t elapsed, uint16_t count)
+{
+    uint64_t sample = ((uint64_t)elapsed << MCF_ADAPTIVE_COST_SHIFT) / count;
+
+    if (sample > UINT32_MAX)
+    {
+        sample = UINT32_MAX;
+    }
+    if (0u == Instance->cost)
+    {
+        Instance->cost = (uint32_t)sample;
+    }
+    else
+    {
+        int64_t delta = (int64_t)sample - (int64_t)Instance->cost;
+        Instance->cost = (uint32_t)((int64_t)Instance->cost + delta / (1 << MCF_ADAPTIVE_EWMA_SHIFT));
+    }
+
+    if (0u == Instance->cost)
+    {
+        Instance->batch = Instance->maxBatch;
+    }
+    else
+    {
+        uint64_t fit = ((uint64_t)Instance->targetLatency << MCF_ADAPTIVE_COST_SHIFT) / Instance->cost;
+        Instance->batch = MCF_adaptive_clamp((fit > UINT32_MAX) ? UINT32_MAX : (uint32_t)fit, Instance->minBatch,
+                                             Instance->maxBatch);
+    }
+}
+
+/**
+ * @brief Messages to parse between tail publishes in a batch of `count`.
+ *
+ * The unpublished messages may hide at most a share of the free space from the
+ * producer and at most a share of `targetLatency` of parse time, so a filling ring
+ * or an expensive parser publishes more often.
+ */
+static uint16_t MCF_adaptive_interval(const MCF_Adaptive_t *Instance, uint16_t room, uint16_t count)
+{
+    uint32_t interval = room >> MCF_ADAPTIVE_FREE_SHIFT;
+
+    if (0u != Instance->cost)
+    {
+        uint64_t span = (((uint64_t)Instance->targetLatency << MCF_ADAPTIVE_COST_SHIFT) / Instance->cost) >>
+                        MCF_ADAPTIVE_PUBLISH_SHIFT;
+
+        if (span < interval)
+        {
+            interval = (uint32_t)span;
+        }
+    }
+    return MCF_adaptive_clamp(interval, 1, count);
+}
+
+void MCF_adaptive_init(MCF_Adaptive_t *Instance, MCF_t *Rx, uint32_t (*getTime)(void), uint32_t TargetLatency,
+                       uint16_t MinBatch, uint16_t MaxBatch)
+{
+    assert((NULL != Instance) && (NULL != Rx) && (NULL != getTime) && (0 < MinBatch) && (MinBatch <= MaxBatch));
+
+    Instance->ring = Rx;
+    Instance->getTime = getTime;
+    Instance->targetLatency = TargetLatency;
+    Instance->minBatch = MinBatch;
+    Instance->maxBatch = MaxBatch;
+    Instance->batch = MinBatch;
+    Instance->publishInterval = 1;
+    Instance->cost = 0;
+}
+
+uint16_t MCF_adaptive_receive(MCF_Adaptive_t *Instance)
+{
+    assert(NULL != Instance);
+
+    MCF_t *Ring = Instance->ring;
+    uint16_t pending = MCF_get_pending(Ring);
+
+    if (0u == pending)
+    {
+        return 0;
+    }
+
+    uint16_t count = (pending < Instance->batch) ? pending : Instance->batch;
+    uint16_t room = (uint16_t)(Ring->msgBufSize - 1u - pending);
+    uint32_t start = Instance->getTime();
+
+    Instance->publishInterval = MCF_adaptive_interval(Instance, room, count);
+
+    /* MCF_peek() acquires the payloads, MCF_release() publishes the tail once per chunk. */
+    for (uint16_t done = 0; done < count;)
+    {
+        uint16_t chunk = (uint16_t)(count - done);
+        uint16_t parsed = 0;
+
+        if (chunk > Instance->publishInterval)
+        {
+            chunk = Instance->publishInterval;
+        }
+        while (parsed < chunk)
+        {
+            MCF_Message_t *Span;
+            uint16_t spanCount = MCF_peek(Ring, parsed, &Span);
+
+            if (spanCount > chunk - parsed)
+            {
+                spanCount = (uint16_t)(chunk - parsed);
+            }
+            for (uint16_t i = 0; i < spanCount; i++)
+            {
+                Ring->msgParser(&Span[i]);
+            }
+            parsed = (uint16_t)(parsed + spanCount);
+        }
+        MCF_release(Ring, chunk);
+        done = (uint16_t)(done + chunk);
+    }
+
+    MCF_adaptive_tune(Instance, Instance->getTime() - start, count);
+    return count;
+}
@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_ADAPTIVE_H_
+#define MULTICORE_FIFO_MCF_ADAPTIVE_H_
+
+#include "MCF.h"
+#include <stdint.h>
+
+/**
+ * @brief Receive loop that sizes its own batches.
+ *
+ * Each call measures the parse cost per message and sets the batch limit of the
+ * next call to what fits in `targetLatency`, so one call never keeps the consumer
+ * away from the rest of its loop longer than the target, whatever the load and
+ * the parser cost.
+ *
+ * Within a batch the tail is published through `MCF_release()` every
+ * `publishInterval` messages instead of after each one, which saves the cache line
+ * transfers of the shared tail. The interval follows the backlog and the target:
+ * with plenty of free space and a cheap parser the tail is published a few times
+ * per batch, and as the ring fills up or parsing gets slower it is published more
+ * often, so the producer never waits long on space that was already consumed.
+ *
+ * - `ring`: Receiving MCF handle (its `msgParser` handles the messages).
+ * - `getTime`: Free-running 32-bit clock used to measure the parse cost.
+ * - `targetLatency`: Longest time one call should take, in clock ticks.
+ * - `minBatch`, `maxBatch`: Bounds of the batch limit.
+ * - `batch`: Batch limit of the next call.
+ * - `publishInterval`: Messages between tail publishes in the last call.
+ * - `cost`: Smoothed parse cost per message, in 1/16 clock ticks.
+ */
+typedef struct
+{
+    MCF_t *ring;
+    uint32_t (*getTime)(void);
+    uint32_t targetLatency;
+    uint16_t minBatch;
+    uint16_t maxBatch;
+    uint16_t batch;
+    uint16_t publishInterval;
+    uint32_t cost;
+} MCF_Adaptive_t;
+
+/**
+ * @brief Initializes the adaptive receive loop of a ring.
+ *
+ * @param Instance      Pointer to the receive loop to initialize.
+ * @param Rx            Initialized receiving MCF handle.
+ * @param getTime       Clock used to measure the parse cost.
+ * @param TargetLatency Longest time one call should take, in clock ticks.
+ * @param MinBatch      Smallest batch limit (at least 1).
+ * @param MaxBatch      Largest batch limit (at least `MinBatch`).
+ */
+void MCF_adaptive_init(MCF_Adaptive_t *Instance, MCF_t *Rx, uint32_t (*getTime)(void), uint32_t TargetLatency,
+                       uint16_t MinBatch, uint16_t MaxBatch);
+
+/**
+ * @brief Receives and parses up to the current batch limit, then retunes it.
+ *
+ * Replaces `MCF_receive()` / `MCF_receive_n()` in the consumer's main loop; it
+ * must be the only consumer of the ring.
+ *
+ * @param Instance Pointer to the receive loop.
+ * @return Number of messages parsed.
+ */
+uint16_t MCF_adaptive_receive(MCF_Adaptive_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_ADAPTIVE_H_ */
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bridge.h"
+#include "assert.h"
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+
+void MCF_bridge_init(MCF_Bridge_t *Instance, MCF_t *Ring, int Fd)
+{
+    assert((NULL != Instance) && (NULL != Ring) && (0 <= Fd));
+
+    memset(Instance, 0, sizeof(*Instance));
+    Instance->ring = Ring;
+    Instance->fd = Fd;
+}
+
+int MCF_bridge_send(MCF_Bridge_t *Instance)
+{
+    assert(NULL != Instance);
+
+    struct mmsghdr mmsg[MCF_BRIDGE_BATCH_FRAMES];
+    uint16_t framed = 0;
+    unsigned int frames = 0;
+
+    /* Frame up to a batch of datagrams straight from the ring; a span ends at the wrap. */
+    while (frames < MCF_BRIDGE_BATCH_FRAMES)
+    {
+        MCF_Message_t *span;
+        uint16_t count = MCF_peek(Instance->ring, framed, &span);
+
+        if (0u == count)
+        {
+            break;
+        }
+        if (count > MCF_BRIDGE_FRAME_MESSAGES)
+        {
+            count = MCF_BRIDGE_FRAME_MESSAGES;
+        }
+
+        Instance->headers[frames] = (MCF_BridgeHeader_t){.seq = Instance->seq + frames, .count = count};
+        Instance->iov[frames][0] = (struct iovec){&Instance->headers[frames], sizeof(MCF_BridgeHeader_t)};
+        Instance->iov[frames][1] = (struct iovec){span, count * sizeof(MCF_Message_t)};
+        mmsg[frames] = (struct mmsghdr){.msg_hdr = {.msg_iov = Instance->iov[frames], .msg_iovlen = 2}};
+        framed = (uint16_t)(framed + count);
+        frames++;
+    }
+    if (0u == frames)
+    {
+        return 0;
+    }
+
+    int sent = sendmmsg(Instance->fd, mmsg, frames, MSG_DONTWAIT);
+    if (0 > sent)
+    {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno)) ? 0 : -1;
+    }
+
+    uint16_t released = 0;
+    for (int i = 0; i < sent; i++)
+    {
+        released = (uint16_t)(released + Instance->headers[i].count);
+    }
+    MCF_release(Instance->ring, released);
+    Instance->seq += (uint32_t)sent;
+    Instance->datagrams += (uint64_t)sent;
+    Instance->messages += released;
+    return released;
+}
+
+int MCF_bridge_receive(MCF_Bridge_t *Instance)
+{
+    assert(NULL != Instance);
+
+    struct mmsghdr mmsg[MCF_BRIDGE_BATCH_FRAMES];
+    uint16_t room = MCF_get_free(Instance->ring);
+    unsigned int frames = room / MCF_BRIDGE_FRAME_MESSAGES;
+
+    /*
+     * Only take datagrams that surely fit; the rest stays queued in the socket, so
+     * a lossless transport pushes back on the sender instead of dropping. A ring
+     * smaller than one frame still takes one datagram at a time when it is empty.
+     */
+    if (frames > MCF_BRIDGE_BATCH_FRAMES)
+    {
+        frames = MCF_BRIDGE_BATCH_FRAMES;
+    }
+    if ((0u == frames) && (room == Instance->ring->msgBufSize - 1u))
+    {
+        frames = 1;
+    }
+    if (0u == frames)
+    {
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        Instance->iov[i][0] = (struct iovec){&Instance->frames[i], sizeof(MCF_BridgeFrame_t)};
+        mmsg[i] = (struct mmsghdr){.msg_hdr = {.msg_iov = Instance->iov[i], .msg_iovlen = 1}};
+    }
+
+    int received = recvmmsg(Instance->fd, mmsg, frames, MSG_DONTWAIT, NULL);
+    if (0 > received)
+    {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+    }
+
+    int injected = 0;
+    for (int i = 0; i < received; i++)
+    {
+        const MCF_BridgeFrame_t *frame = &Instance->frames[i];
+        size_t length = mmsg[i].msg_len;
+        uint16_t count = frame->header.count;
+
+        /* Discard truncated datagrams, runts and lengths that disagree with the header. */
+        if ((0 != (mmsg[i].msg_hdr.msg_flags & MSG_TRUNC)) || (length < sizeof(MCF_BridgeHeader_t)) ||
+            (count > MCF_BRIDGE_FRAME_MESSAGES) ||
+            (length != sizeof(MCF_BridgeHeader_t) + count * sizeof(MCF_Message_t)))
+        {
+            Instance->malformed++;
+            continue;
+        }
+
+        /* A late (reordered) datagram is still injected but does not move the sequence back. */
+        int32_t gap = (int32_t)(frame->header.seq - Instance->seq);
+        if (0 <= gap)
+        {
+            Instance->lostDatagrams += (uint32_t)gap;
+            Instance->seq = frame->header.seq + 1u;
+        }
+        else if (0u < Instance->lostDatagrams)
+        {
+            Instance->lostDatagrams--;
+        }
+        Instance->datagrams++;
+
+        uint16_t sent = MCF_send_batch(Instance->ring, frame->msgs, count);
+        Instance->dropped += (uint16_t)(count - sent);
+        Instance->messages += sent;
+        injected += sent;
+    }
+    return injected;
+}
@@ -0,0 +1,132 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_BRIDGE_H_
+#define MULTICORE_FIFO_MCF_BRIDGE_H_
+
+#include "MCF.h"
+#include <stdint.h>
+#include <sys/uio.h>
+
+/** Messages per datagram; 8 + 128 * 8 = 1032 bytes fits an Ethernet MTU. */
+#ifndef MCF_BRIDGE_FRAME_MESSAGES
+#define MCF_BRIDGE_FRAME_MESSAGES 128u
+#endif
+
+/** Datagrams per `sendmmsg()` / `recvmmsg()` call. */
+#ifndef MCF_BRIDGE_BATCH_FRAMES
+#define MCF_BRIDGE_BATCH_FRAMES 16u
+#endif
+
+/**
+ * @brief Header in front of the messages of every datagram.
+ *
+ * Messages follow as raw `MCF_Message_t` in host byte order and layout, so both
+ * ends must share the ABI (same host, or identical targets).
+ *
+ * - `seq`: Datagram sequence number, used by the receiver to count lost datagrams.
+ * - `count`: Number of messages in the datagram.
+ * - `reserved`: Zero.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint16_t count;
+    uint16_t reserved;
+} MCF_BridgeHeader_t;
+
+/**
+ * @brief A received datagram (receiving side of a bridge).
+ */
+typedef struct
+{
+    MCF_BridgeHeader_t header;
+    MCF_Message_t msgs[MCF_BRIDGE_FRAME_MESSAGES];
+} MCF_BridgeFrame_t;
+
+/**
+ * @brief One end of a bridge carrying an MCF stream over a datagram socket.
+ *
+ * The sending end drains `ring` (it is its consumer): pending messages are framed
+ * straight from the ring slots with `MCF_peek()` and sent with one `sendmmsg()`
+ * per up to `MCF_BRIDGE_BATCH_FRAMES` datagrams, then released. The receiving end
+ * fills `ring` (it is its producer): one `recvmmsg()` collects a batch of
+ * datagrams, each re-injected with `MCF_send_batch()`.
+ *
+ * Any connected datagram socket works: UDP (e.g. on loopback), or `AF_UNIX`
+ * `SOCK_DGRAM` / `SOCK_SEQPACKET`, which keep message boundaries so no stream
+ * reassembly is needed. The socket is created, bound and connected by the
+ * caller; the bridge only uses it non-blocking.
+ *
+ * - `ring`: Ring drained (sending end) or filled (receiving end).
+ * - `fd`: Connected datagram socket.
+ * - `seq`: Next datagram sequence number sent or expected.
+ * - `datagrams`: Datagrams sent or received.
+ * - `messages`: Messages sent or re-injected.
+ * - `lostDatagrams`: Receiving end: datagrams missing from the sequence.
+ * - `dropped`: Receiving end: messages that did not fit into `ring`.
+ * - `malformed`: Receiving end: datagrams discarded as truncated, too short, or
+ *   with a length that disagrees with their header.
+ * - `headers`: Sending end: datagram headers of the current batch.
+ * - `iov`: Buffers of every datagram of the current batch.
+ * - `frames`: Receiving end: datagram buffers for `recvmmsg()`.
+ */
+typedef struct
+{
+    MCF_t *ring;
+    int fd;
+    uint32_t seq;
+    uint64_t datagrams;
+    uint64_t messages;
+    uint64_t lostDatagrams;
+    uint64_t dropped;
+    uint64_t malformed;
+    MCF_BridgeHeader_t headers[MCF_BRIDGE_BATCH_FRAMES];
+    struct iovec iov[MCF_BRIDGE_BATCH_FRAMES][2];
+    MCF_BridgeFrame_t frames[MCF_BRIDGE_BATCH_FRAMES];
+} MCF_Bridge_t;
+
+/**
+ * @brief Initializes one end of a bridge.
+ *
+ * @param Instance Pointer to the bridge end to initialize.
+ * @param Ring     Receiving MCF handle to drain (sending end) or sending handle
+ *                 to fill (receiving end).
+ * @param Fd       Connected datagram socket.
+ */
+void MCF_bridge_init(MCF_Bridge_t *Instance, MCF_t *Ring, int Fd);
+
+/**
+ * @brief Sends the pending messages of the ring in batched datagrams.
+ *
+ * Does not block. Messages are released from the ring once the kernel accepted
+ * their datagram; whatever the socket did not take stays pending for the next call.
+ *
+ * @param Instance Pointer to the sending end.
+ * @return Number of messages sent, or -1 on a socket error (errno is set).
+ */
+int MCF_bridge_send(MCF_Bridge_t *Instance);
+
+/**
+ * @brief Receives a batch of datagrams and re-injects their messages into the ring.
+ *
+ * Does not block. Only as many datagrams are taken from the socket as surely fit
+ * into the ring (`MCF_BRIDGE_FRAME_MESSAGES` free slots each); the others stay
+ * queued, so on `AF_UNIX` sockets the sender is held back and nothing is lost,
+ * while UDP drops at the socket once its buffer is full. Messages are only
+ * dropped (and counted in `dropped`) if a datagram is larger than the whole ring.
+ * Datagrams that are not valid frames are discarded and counted in `malformed`.
+ *
+ * @param Instance Pointer to the receiving end.
+ * @return Number of messages re-injected, or -1 on a socket error (errno is set).
+ */
+int MCF_bridge_receive(MCF_Bridge_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_BRIDGE_H_ */
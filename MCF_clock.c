@@ -0,0 +1,185 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_clock.h"
+#include "assert.h"
+#include <stddef.h>
+
+/**
+ * @brief State of the measuring side.
+ *
+ * The MCF parser has no context argument, so each side keeps one static state:
+ * a core calibrates against one remote at a time.
+ */
+static struct
+{
+    MCF_t *tx;
+    MCF_t *rx;
+    uint64_t (*getTime)(void);
+    uint32_t expectedSeq;
+    uint8_t seqMatched;
+    uint32_t stampLo;
+    uint64_t stamp;
+    volatile uint8_t stampReady;
+} clockLocal;
+
+/**
+ * @brief State of the responding side.
+ */
+static struct
+{
+    MCF_t *tx;
+    MCF_t *rx;
+    uint64_t (*getTime)(void);
+} clockRemote;
+
+/**
+ * @brief Collects the reply to the outstanding ping: PONG(seq), STAMP_LO, STAMP_HI.
+ *
+ * Replies to pings that already timed out carry an old sequence number and are ignored.
+ */
+static void MCF_clock_local_parser(MCF_Message_t *msgBuf)
+{
+    switch (msgBuf->msgID) {
+    case MCF_CLOCK_MSG_PONG:
+        clockLocal.seqMatched = (msgBuf->u32 == clockLocal.expectedSeq);
+        break;
+    case MCF_CLOCK_MSG_STAMP_LO:
+        clockLocal.stampLo = msgBuf->u32;
+        break;
+    case MCF_CLOCK_MSG_STAMP_HI:
+        if (clockLocal.seqMatched)
+        {
+            clockLocal.stamp = ((uint64_t)msgBuf->u32 << 32) | clockLocal.stampLo;
+            clockLocal.stampReady = 1;
+            clockLocal.seqMatched = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Answers a ping with the remote time at which it was handled.
+ */
+static void MCF_clock_remote_parser(MCF_Message_t *msgBuf)
+{
+    if (MCF_CLOCK_MSG_PING == msgBuf->msgID)
+    {
+        uint64_t now = clockRemote.getTime();
+
+        MCF_send_u32(clockRemote.tx, MCF_CLOCK_MSG_PONG, msgBuf->u32);
+        MCF_send_u32(clockRemote.tx, MCF_CLOCK_MSG_STAMP_LO, (uint32_t)now);
+        MCF_send_u32(clockRemote.tx, MCF_CLOCK_MSG_STAMP_HI, (uint32_t)(now >> 32));
+    }
+}
+
+void MCF_clock_bind_local(MCF_t *Tx, MCF_t *Rx, uint64_t (*getTime)(void))
+{
+    assert((NULL != Tx) && (NULL != Rx) && (NULL != getTime));
+
+    clockLocal.tx = Tx;
+    clockLocal.rx = Rx;
+    clockLocal.getTime = getTime;
+    Rx->msgParser = MCF_clock_local_parser;
+}
+
+void MCF_clock_bind_remote(MCF_t *Tx, MCF_t *Rx, uint64_t (*getTime)(void))
+{
+    /* Every ping is answered with three messages. */
+    assert((NULL != Tx) && (NULL != Rx) && (NULL != getTime) && (4 <= Tx->msgBufSize));
+
+    clockRemote.tx = Tx;
+    clockRemote.rx = Rx;
+    clockRemote.getTime = getTime;
+    Rx->msgParser = MCF_clock_remote_parser;
+}
+
+void MCF_clock_respond(void)
+{
+    assert(NULL != clockRemote.rx);
+
+    MCF_receive(clockRemote.rx);
+}
+
+int MCF_clock_calibrate(MCF_ClockSync_t *Sync, uint16_t exchanges, uint64_t timeout)
+{
+    assert((NULL != Sync) && (NULL != clockLocal.tx));
+
+    uint64_t bestRtt = UINT64_MAX;
+    int64_t bestOffset = 0;
+    uint64_t bestMid = 0;
+
+    for (uint16_t i = 0; i < exchanges; i++)
+    {
+        clockLocal.expectedSeq++;
+        clockLocal.stampReady = 0;
+
+        uint64_t sent = clockLocal.getTime();
+        MCF_send_u32(clockLocal.tx, MCF_CLOCK_MSG_PING, clockLocal.expectedSeq);
+
+        while (!clockLocal.stampReady && ((clockLocal.getTime() - sent) < timeout))
+        {
+            MCF_receive(clockLocal.rx);
+        }
+
+        uint64_t received = clockLocal.getTime();
+        if (!clockLocal.stampReady)
+        {
+            continue;
+        }
+
+        /* The remote stamp is assumed to be taken halfway through the round trip. */
+        uint64_t rtt = received - sent;
+        if (rtt < bestRtt)
+        {
+            bestRtt = rtt;
+            bestMid = sent + (rtt / 2u);
+            bestOffset = (int64_t)(clockLocal.stamp - bestMid);
+        }
+    }
+
+    if (UINT64_MAX == bestRtt)
+    {
+        return -1;
+    }
+
+    if (Sync->valid && (bestMid > Sync->refTime))
+    {
+        /* Each offset is only known to +/- rtt / 2; a change within that is noise, not drift. */
+        int64_t offsetChange = bestOffset - Sync->offset;
+        uint64_t change = (offsetChange < 0) ? (uint64_t)-offsetChange : (uint64_t)offsetChange;
+        uint64_t uncertainty = (Sync->rtt + bestRtt) / 2u;
+
+        if (change > MCF_CLOCK_DRIFT_MARGIN * uncertainty)
+        {
+            Sync->driftPpb = (int64_t)(((double)offsetChange * 1e9) / (double)(bestMid - Sync->refTime));
+        }
+    }
+
+    Sync->offset = bestOffset;
+    Sync->refTime = bestMid;
+    Sync->rtt = bestRtt;
+    Sync->valid = 1;
+    return 0;
+}
+
+uint64_t MCF_clock_to_local(const MCF_ClockSync_t *Sync, uint64_t remoteTime)
+{
+    assert(NULL != Sync);
+
+    int64_t local = (int64_t)(remoteTime - (uint64_t)Sync->offset);
+    int64_t sinceRef = local - (int64_t)Sync->refTime;
+
+    /* Remove the offset accumulated by the rate difference since the reference point. */
+    local -= (int64_t)(((double)sinceRef * (double)Sync->driftPpb) / 1e9);
+    return (uint64_t)local;
+}
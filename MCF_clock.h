@@ -0,0 +1,112 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_CLOCK_H_
+#define MULTICORE_FIFO_MCF_CLOCK_H_
+
+#include "MCF.h"
+#include <stdint.h>
+
+/** Message IDs used on the calibration rings. */
+#define MCF_CLOCK_MSG_PING 0xFFF0u
+#define MCF_CLOCK_MSG_PONG 0xFFF1u
+#define MCF_CLOCK_MSG_STAMP_LO 0xFFF2u
+#define MCF_CLOCK_MSG_STAMP_HI 0xFFF3u
+
+/**
+ * Drift is only updated when the offset moved by more than this many times the
+ * combined uncertainty of the two estimates.
+ */
+#ifndef MCF_CLOCK_DRIFT_MARGIN
+#define MCF_CLOCK_DRIFT_MARGIN 4u
+#endif
+
+/**
+ * @brief Estimated relation between the remote core's clock and the local one.
+ *
+ * Timestamps taken on different cores (cycle counters, free running timers) are
+ * offset from each other and may run at slightly different rates. The estimate
+ * models the remote clock as `remote = local + offset + drift * (local - refTime)`.
+ *
+ * - `offset`: Remote minus local clock at `refTime`, in clock ticks.
+ * - `refTime`: Local time at which `offset` was measured.
+ * - `driftPpb`: Rate of the remote clock relative to the local one, in parts per billion.
+ *   Zero until two calibrations lie far enough apart for the offset change to exceed
+ *   their uncertainty (see `MCF_CLOCK_DRIFT_MARGIN`); kept otherwise.
+ * - `rtt`: Round trip time of the exchange the offset was taken from (its uncertainty is rtt / 2).
+ * - `valid`: Non-zero once a calibration succeeded.
+ */
+typedef struct
+{
+    int64_t offset;
+    uint64_t refTime;
+    int64_t driftPpb;
+    uint64_t rtt;
+    uint8_t valid;
+} MCF_ClockSync_t;
+
+/**
+ * @brief Binds the local (measuring) side of the calibration to a dedicated ring pair.
+ *
+ * `Tx` carries pings to the remote core and `Rx` carries its replies. Both must be
+ * initialized with `MCF_init_TX()` / `MCF_init_RX()` and used for nothing else;
+ * the parser of `Rx` is replaced by the calibration parser.
+ *
+ * @param Tx      Ring towards the remote core.
+ * @param Rx      Ring from the remote core.
+ * @param getTime Local clock.
+ */
+void MCF_clock_bind_local(MCF_t *Tx, MCF_t *Rx, uint64_t (*getTime)(void));
+
+/**
+ * @brief Binds the remote (responding) side of the calibration.
+ *
+ * Each ping is answered with three messages, so `Tx` must hold at least 4 messages.
+ *
+ * @param Tx      Ring towards the local core (the local side's `Rx`).
+ * @param Rx      Ring from the local core (the local side's `Tx`).
+ * @param getTime Remote clock.
+ */
+void MCF_clock_bind_remote(MCF_t *Tx, MCF_t *Rx, uint64_t (*getTime)(void));
+
+/**
+ * @brief Answers pending pings; call regularly on the remote core during calibration.
+ */
+void MCF_clock_respond(void);
+
+/**
+ * @brief Runs ping-pong exchanges and updates the clock estimate.
+ *
+ * Each exchange records the local send time, the remote time when the ping was
+ * answered and the local receive time. The exchange with the shortest round trip
+ * gives the offset (NTP-style midpoint). When `Sync` already holds an earlier
+ * estimate, the change of the offset over time gives the drift, so calling this
+ * periodically keeps both up to date. A change smaller than the round trips can
+ * resolve leaves the drift as it was.
+ *
+ * The remote core must be calling `MCF_clock_respond()` meanwhile.
+ *
+ * @param Sync      Estimate to update.
+ * @param exchanges Number of ping-pong exchanges.
+ * @param timeout   Maximum wait for a single reply, in local clock ticks.
+ * @return 0 on success, -1 when no exchange completed.
+ */
+int MCF_clock_calibrate(MCF_ClockSync_t *Sync, uint16_t exchanges, uint64_t timeout);
+
+/**
+ * @brief Converts a timestamp taken on the remote core to the local time base.
+ *
+ * @param Sync       Calibrated estimate.
+ * @param remoteTime Remote clock value.
+ * @return The corresponding local clock value.
+ */
+uint64_t MCF_clock_to_local(const MCF_ClockSync_t *Sync, uint64_t remoteTime);
+
+#endif /* MULTICORE_FIFO_MCF_CLOCK_H_ */
@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_CRC_H_
+#define MULTICORE_FIFO_MCF_CRC_H_
+
+#include "MCF.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** Message ID reserved for batch trailers; applications must not send it. */
+#ifndef MCF_CRC_TRAILER_ID
+#define MCF_CRC_TRAILER_ID 0xFFFFu
+#endif
+
+/**
+ * @brief Updates a CRC32C (Castagnoli) over a byte buffer.
+ *
+ * Runs the implementation `MCF_dispatch` selected for the CPU: SSE4.2 on x86
+ * processors that have it, the ARMv8 CRC instructions on AArch64 processors that
+ * have them, a lookup table otherwise. Start with 0 and pass
+ * the previous result to continue; `MCF_crc32c(0, "123456789", 9)` is
+ * `0xE3069283`.
+ *
+ * @param Crc    CRC of the preceding data, 0 to start.
+ * @param Data   Bytes to add.
+ * @param Length Number of bytes.
+ * @return The updated CRC.
+ */
+uint32_t MCF_crc32c(uint32_t Crc, const void *Data, size_t Length);
+
+/**
+ * @brief Updates a CRC32C over messages.
+ *
+ * Each message counts as the 8 bytes of `msgID | (u32 << 32)` in little-endian
+ * order, so padding bytes never change the result and both sides agree
+ * regardless of byte order.
+ *
+ * @param Crc   CRC of the preceding messages, 0 to start.
+ * @param Msgs  Messages to add.
+ * @param count Number of messages.
+ * @return The updated CRC.
+ */
+uint32_t MCF_crc32c_messages(uint32_t Crc, const MCF_Message_t *Msgs, uint16_t count);
+
+/**
+ * @brief Name of the CRC32C implementation in use ("sse4.2", "armv8", "table").
+ */
+const char *MCF_crc32c_impl(void);
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MCF_CRC_HAVE_SSE42 1
+#endif
+
+/* Built for every little-endian AArch64 target; `MCF_dispatch` checks the CPU at run time. */
+#if defined(__aarch64__) && defined(__GNUC__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MCF_CRC_HAVE_ARMV8 1
+#endif
+
+/**
+ * @name CRC32C implementations
+ *
+ * Same contract as `MCF_crc32c()` / `MCF_crc32c_messages()`; called through
+ * `MCF_dispatch`, exposed for tests and benchmarks. The SSE4.2 ones may only be
+ * called if `MCF_dispatch_detect()` reports `MCF_CPU_SSE4_2`, the ARMv8 ones if it
+ * reports `MCF_CPU_ARM_CRC32`.
+ * @{
+ */
+uint32_t MCF_crc32c_table(uint32_t Crc, const void *Data, size_t Length);
+uint32_t MCF_crc32c_messages_table(uint32_t Crc, const MCF_Message_t *Msgs, uint16_t count);
+#if defined(MCF_CRC_HAVE_SSE42)
+uint32_t MCF_crc32c_sse42(uint32_t Crc, const void *Data, size_t Length);
+uint32_t MCF_crc32c_messages_sse42(uint32_t Crc, const MCF_Message_t *Msgs, uint16_t count);
+#endif
+#if defined(MCF_CRC_HAVE_ARMV8)
+uint32_t MCF_crc32c_armv8(uint32_t Crc, const void *Data, size_t Length);
+uint32_t MCF_crc32c_messages_armv8(uint32_t Crc, const MCF_Message_t *Msgs, uint16_t count);
+#endif
+/** @} */
+
+/**
+ * @brief Sends a batch followed by a trailer holding the batch's CRC32C.
+ *
+ * All or nothing: the batch is only sent if it fits together with its trailer.
+ * The CRC is computed over `Msgs`, before they are written to the ring, so
+ * corruption of the ring memory in between is caught by the consumer.
+ *
+ * @param Instance Pointer to the sending MCF instance.
+ * @param Msgs     Messages to send; none may use `MCF_CRC_TRAILER_ID`.
+ * @param count    Number of messages, at most the ring capacity minus one.
+ * @return `count` if the batch was sent, 0 if it did not fit.
+ */
+uint16_t MCF_crc_send_batch(MCF_t *Instance, const MCF_Message_t *Msgs, uint16_t count);
+
+/**
+ * @brief Consumer side of CRC-protected batches.
+ *
+ * A batch is dispatched to the ring's `msgParser` only after its trailer arrived
+ * and the CRC of the messages in the ring matched it; a batch that does not match
+ * is released without being parsed. The CRC of a batch whose trailer is not
+ * published yet is kept, so pending messages are not checked twice.
+ *
+ * - `ring`: Receiving MCF handle; its parser gets the verified messages.
+ * - `scanned`: Messages of the open batch already folded into `crc`.
+ * - `crc`: CRC of those messages.
+ * - `batches`: Batches verified and dispatched.
+ * - `corrupt`: Batches rejected.
+ * - `messages`: Messages dispatched.
+ * - `discarded`: Messages of rejected batches.
+ */
+typedef struct
+{
+    MCF_t *ring;
+    uint16_t scanned;
+    uint32_t crc;
+    uint32_t batches;
+    uint32_t corrupt;
+    uint32_t messages;
+    uint32_t discarded;
+} MCF_CrcReceiver_t;
+
+/**
+ * @brief Initializes the consumer side.
+ *
+ * @param Instance Pointer to the receiver to initialize.
+ * @param Rx       Initialized receiving MCF handle.
+ */
+void MCF_crc_receiver_init(MCF_CrcReceiver_t *Instance, MCF_t *Rx);
+
+/**
+ * @brief Verifies and dispatches every complete batch pending in the ring.
+ *
+ * If the ring fills up without a trailer (a trailer was corrupted into another
+ * ID), the pending messages are rejected as one batch so the stream can
+ * resynchronize on the next trailer.
+ *
+ * @param Instance Pointer to the receiver.
+ * @return Number of messages dispatched.
+ */
+uint32_t MCF_crc_receive(MCF_CrcReceiver_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_CRC_H_ */
@@ -0,0 +1,210 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_deadband.h"
+#include "assert.h"
+#include <math.h>
+#include <stddef.h>
+
+/**
+ * @brief Binary search of the table; NULL for IDs without a deadband.
+ */
+static MCF_DeadbandEntry_t *MCF_deadband_find(MCF_Deadband_t *Instance, uint16_t msgID)
+{
+    uint16_t low = 0;
+    uint16_t high = Instance->entryCount;
+
+    while (low < high)
+    {
+        uint16_t mid = (uint16_t)(low + (high - low) / 2u);
+
+        if (Instance->entries[mid].msgID < msgID)
+        {
+            low = (uint16_t)(mid + 1u);
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return ((low < Instance->entryCount) && (msgID == Instance->entries[low].msgID)) ? &Instance->entries[low] : NULL;
+}
+
+/**
+ * @brief Decides whether a value `change` away from the last sent `last` must be sent.
+ *
+ * Written as "not within the band" so a NaN change always counts as significant;
+ * the caller passes a zero change for NaN to NaN.
+ */
+static int MCF_deadband_significant(MCF_Deadband_t *Instance, MCF_DeadbandEntry_t *Entry, float change, float last)
+{
+    if (NULL == Entry)
+    {
+        return 1;
+    }
+    if (!Entry->valid)
+    {
+        return 1;
+    }
+    if ((0u != Entry->maxSilence) && ((uint32_t)(Instance->getTime() - Entry->lastTime) >= Entry->maxSilence))
+    {
+        return 1;
+    }
+
+    float magnitude = (last < 0.0f) ? -last : last;
+    float band = Entry->relative * magnitude;
+
+    /* Also taken when `last` is NaN, which makes the relative band NaN. */
+    if (!(band >= Entry->absolute))
+    {
+        band = Entry->absolute;
+    }
+    if ((change < 0.0f) ? (-change <= band) : (change <= band))
+    {
+        Entry->suppressed++;
+        Instance->suppressed++;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Records a sent message as the new reference value.
+ */
+static void MCF_deadband_sent(MCF_Deadband_t *Instance, MCF_DeadbandEntry_t *Entry, const MCF_Message_t *Msg)
+{
+    Instance->passed++;
+    if (NULL != Entry)
+    {
+        Entry->last = *Msg;
+        Entry->valid = 1;
+        if (0u != Entry->maxSilence)
+        {
+            Entry->lastTime = Instance->getTime();
+        }
+    }
+}
+
+void MCF_deadband_init(MCF_Deadband_t *Instance, MCF_t *Tx, MCF_DeadbandEntry_t *Entries, uint16_t EntryCount,
+                       uint32_t (*getTime)(void))
+{
+    assert((NULL != Instance) && (NULL != Tx) && ((NULL != Entries) || (0 == EntryCount)));
+
+    for (uint16_t i = 0; i < EntryCount; i++)
+    {
+        assert((0 == i) || (Entries[i - 1u].msgID < Entries[i].msgID));
+        assert((0u == Entries[i].maxSilence) || (NULL != getTime));
+
+        Entries[i].last = (MCF_Message_t){.msgID = Entries[i].msgID};
+        Entries[i].lastTime = 0;
+        Entries[i].valid = 0;
+        Entries[i].suppressed = 0;
+    }
+
+    Instance->tx = Tx;
+    Instance->entries = Entries;
+    Instance->entryCount = EntryCount;
+    Instance->getTime = getTime;
+    Instance->passed = 0;
+    Instance->suppressed = 0;
+}
+
+int MCF_deadband_send_u16(MCF_Deadband_t *Instance, uint16_t msgID, uint16_t value)
+{
+    assert(NULL != Instance);
+
+    MCF_DeadbandEntry_t *Entry = MCF_deadband_find(Instance, msgID);
+    float last = (NULL != Entry) ? (float)Entry->last.u16 : 0.0f;
+
+    if (!MCF_deadband_significant(Instance, Entry, (float)value - last, last))
+    {
+        return 0;
+    }
+
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+    MCF_send_u16(Instance->tx, msgID, value);
+    MCF_deadband_sent(Instance, Entry, &msg);
+    return 1;
+}
+
+int MCF_deadband_send_i16(MCF_Deadband_t *Instance, uint16_t msgID, int16_t value)
+{
+    assert(NULL != Instance);
+
+    MCF_DeadbandEntry_t *Entry = MCF_deadband_find(Instance, msgID);
+    float last = (NULL != Entry) ? (float)Entry->last.i16 : 0.0f;
+
+    if (!MCF_deadband_significant(Instance, Entry, (float)value - last, last))
+    {
+        return 0;
+    }
+
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+    MCF_send_i16(Instance->tx, msgID, value);
+    MCF_deadband_sent(Instance, Entry, &msg);
+    return 1;
+}
+
+int MCF_deadband_send_u32(MCF_Deadband_t *Instance, uint16_t msgID, uint32_t value)
+{
+    assert(NULL != Instance);
+
+    MCF_DeadbandEntry_t *Entry = MCF_deadband_find(Instance, msgID);
+    uint32_t last = (NULL != Entry) ? Entry->last.u32 : 0u;
+
+    /* Difference in 64 bits: converting both values to float first would lose small changes of large values. */
+    if (!MCF_deadband_significant(Instance, Entry, (float)((int64_t)value - (int64_t)last), (float)last))
+    {
+        return 0;
+    }
+
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+    MCF_send_u32(Instance->tx, msgID, value);
+    MCF_deadband_sent(Instance, Entry, &msg);
+    return 1;
+}
+
+int MCF_deadband_send_i32(MCF_Deadband_t *Instance, uint16_t msgID, int32_t value)
+{
+    assert(NULL != Instance);
+
+    MCF_DeadbandEntry_t *Entry = MCF_deadband_find(Instance, msgID);
+    int32_t last = (NULL != Entry) ? Entry->last.i32 : 0;
+
+    if (!MCF_deadband_significant(Instance, Entry, (float)((int64_t)value - (int64_t)last), (float)last))
+    {
+        return 0;
+    }
+
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+    MCF_send_i32(Instance->tx, msgID, value);
+    MCF_deadband_sent(Instance, Entry, &msg);
+    return 1;
+}
+
+int MCF_deadband_send_f32(MCF_Deadband_t *Instance, uint16_t msgID, float value)
+{
+    assert(NULL != Instance);
+
+    MCF_DeadbandEntry_t *Entry = MCF_deadband_find(Instance, msgID);
+    float last = (NULL != Entry) ? Entry->last.f32 : 0.0f;
+    /* A channel stuck at NaN has not changed. */
+    float change = (isnan(value) && isnan(last)) ? 0.0f : value - last;
+
+    if (!MCF_deadband_significant(Instance, Entry, change, last))
+    {
+        return 0;
+    }
+
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+    MCF_send_f32(Instance->tx, msgID, value);
+    MCF_deadband_sent(Instance, Entry, &msg);
+    return 1;
+}
@@ -0,0 +1,138 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_DEADBAND_H_
+#define MULTICORE_FIFO_MCF_DEADBAND_H_
+
+#include "MCF.h"
+#include <stdint.h>
+
+/**
+ * @brief Deadband of one message ID.
+ *
+ * A value is sent when it differs from the last sent value by more than
+ * `max(absolute, relative * |last|)`, when `maxSilence` ticks passed since the
+ * last send, or when nothing was sent yet. With both thresholds 0 only exact
+ * repeats are suppressed.
+ *
+ * Configuration (set by the caller):
+ * - `msgID`: Message ID the entry applies to; entries are sorted by it.
+ * - `absolute`: Change threshold in value units.
+ * - `relative`: Change threshold as a fraction of the last sent value.
+ * - `maxSilence`: Longest time without a send, in clock ticks; 0 for no limit.
+ *
+ * State (reset by `MCF_deadband_init()`):
+ * - `last`: Last sent message.
+ * - `lastTime`: Time of the last send.
+ * - `valid`: Non-zero once a value was sent.
+ * - `suppressed`: Messages of this ID filtered out.
+ */
+typedef struct
+{
+    uint16_t msgID;
+    float absolute;
+    float relative;
+    uint32_t maxSilence;
+    MCF_Message_t last;
+    uint32_t lastTime;
+    uint8_t valid;
+    uint32_t suppressed;
+} MCF_DeadbandEntry_t;
+
+/**
+ * @brief Report-by-exception filter in front of an MCF ring.
+ *
+ * Producer side: the `MCF_deadband_send_*()` functions look the message ID up in
+ * the table and only pass significant changes on to `MCF_send_*()`. IDs missing
+ * from the table are always sent. The consumer keeps the last received value per
+ * ID, which stays within the deadband of the producer's current value.
+ *
+ * - `tx`: Sending MCF handle.
+ * - `entries`: Deadband table, sorted by `msgID`.
+ * - `entryCount`: Number of entries.
+ * - `getTime`: Clock for `maxSilence`; may be NULL if no entry uses it.
+ * - `passed`: Messages sent to the ring.
+ * - `suppressed`: Messages filtered out.
+ */
+typedef struct
+{
+    MCF_t *tx;
+    MCF_DeadbandEntry_t *entries;
+    uint16_t entryCount;
+    uint32_t (*getTime)(void);
+    uint32_t passed;
+    uint32_t suppressed;
+} MCF_Deadband_t;
+
+/**
+ * @brief Initializes the filter and resets the state of every entry.
+ *
+ * @param Instance   Pointer to the filter to initialize.
+ * @param Tx         Initialized sending MCF handle.
+ * @param Entries    Deadband table sorted by `msgID`, configuration filled in.
+ * @param EntryCount Number of entries.
+ * @param getTime    Clock for `maxSilence`, or NULL if no entry uses it.
+ */
+void MCF_deadband_init(MCF_Deadband_t *Instance, MCF_t *Tx, MCF_DeadbandEntry_t *Entries, uint16_t EntryCount,
+                       uint32_t (*getTime)(void));
+
+/**
+ * @brief Sends a uint16_t message if it is significant.
+ *
+ * @param Instance Pointer to the filter.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return 1 if the message was sent, 0 if it was suppressed.
+ */
+int MCF_deadband_send_u16(MCF_Deadband_t *Instance, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Sends an int16_t message if it is significant.
+ *
+ * @param Instance Pointer to the filter.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit signed value to include in the message payload.
+ * @return 1 if the message was sent, 0 if it was suppressed.
+ */
+int MCF_deadband_send_i16(MCF_Deadband_t *Instance, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Sends a uint32_t message if it is significant.
+ *
+ * @param Instance Pointer to the filter.
+ * @param msgID    Identifier of the message to send.
+ * @param value    32-bit unsigned value to include in the message payload.
+ * @return 1 if the message was sent, 0 if it was suppressed.
+ */
+int MCF_deadband_send_u32(MCF_Deadband_t *Instance, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Sends an int32_t message if it is significant.
+ *
+ * @param Instance Pointer to the filter.
+ * @param msgID    Identifier of the message to send.
+ * @param value    32-bit signed value to include in the message payload.
+ * @return 1 if the message was sent, 0 if it was suppressed.
+ */
+int MCF_deadband_send_i32(MCF_Deadband_t *Instance, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Sends a float message if it is significant.
+ *
+ * A change to or from NaN is always significant; NaN following NaN is not.
+ *
+ * @param Instance Pointer to the filter.
+ * @param msgID    Identifier of the message to send.
+ * @param value    Floating-point value to include in the message payload.
+ * @return 1 if the message was sent, 0 if it was suppressed.
+ */
+int MCF_deadband_send_f32(MCF_Deadband_t *Instance, uint16_t msgID, float value);
+
+#endif /* MULTICORE_FIFO_MCF_DEADBAND_H_ */
@@ -0,0 +1,135 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * A function-pointer table rather than ifunc resolvers: it works with any
+ * toolchain and C library, can be re-resolved with a feature mask for testing,
+ * and costs the same single indirect call.
+ */
+
+#include "MCF_dispatch.h"
+#include "MCF_crc.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define MCF_DISPATCH_X86 1
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1u << 7)
+#endif
+#define MCF_DISPATCH_AARCH64_LINUX 1
+#endif
+
+MCF_Dispatch_t MCF_dispatch = {
+    .features = 0,
+    .crc32c = MCF_crc32c_table,
+    .crc32cMessages = MCF_crc32c_messages_table,
+    .crc32cName = "table",
+};
+
+#if defined(MCF_DISPATCH_X86)
+/**
+ * @brief Reads XCR0: which register states the OS saves on a context switch.
+ */
+__attribute__((target("xsave"))) static uint64_t MCF_dispatch_xcr0(void)
+{
+    uint32_t low;
+    uint32_t high;
+
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((uint64_t)high << 32) | low;
+}
+#endif
+
+uint32_t MCF_dispatch_detect(void)
+{
+    uint32_t features = 0;
+
+#if defined(MCF_DISPATCH_X86)
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int ecx;
+    unsigned int edx;
+    uint64_t xcr0 = 0;
+
+    if (0 != __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        if (0u != (ecx & bit_SSE4_2))
+        {
+            features |= MCF_CPU_SSE4_2;
+        }
+        if (0u != (ecx & bit_OSXSAVE))
+        {
+            xcr0 = MCF_dispatch_xcr0();
+        }
+    }
+    /* AVX needs the XMM and YMM states saved, AVX-512 the opmask and ZMM states as well. */
+    if (0 != __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        if ((0u != (ebx & bit_AVX2)) && (0x06u == (xcr0 & 0x06u)))
+        {
+            features |= MCF_CPU_AVX2;
+        }
+        if ((0u != (ebx & bit_AVX512F)) && (0xE6u == (xcr0 & 0xE6u)))
+        {
+            features |= MCF_CPU_AVX512F;
+        }
+    }
+#elif defined(MCF_DISPATCH_AARCH64_LINUX)
+    if (0u != (getauxval(AT_HWCAP) & HWCAP_CRC32))
+    {
+        features |= MCF_CPU_ARM_CRC32;
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    features |= MCF_CPU_ARM_CRC32;
+#endif
+
+    return features;
+}
+
+void MCF_dispatch_init(uint32_t Mask)
+{
+    MCF_Dispatch_t table = {
+        .features = MCF_dispatch_detect() & Mask,
+        .crc32c = MCF_crc32c_table,
+        .crc32cMessages = MCF_crc32c_messages_table,
+        .crc32cName = "table",
+    };
+
+    /* CRC32C has no wider kernel: the AVX2 and AVX-512 levels use SSE4.2. */
+#if defined(MCF_CRC_HAVE_SSE42)
+    if (0u != (table.features & MCF_CPU_SSE4_2))
+    {
+        table.crc32c = MCF_crc32c_sse42;
+        table.crc32cMessages = MCF_crc32c_messages_sse42;
+        table.crc32cName = "sse4.2";
+    }
+#endif
+#if defined(MCF_CRC_HAVE_ARMV8)
+    if (0u != (table.features & MCF_CPU_ARM_CRC32))
+    {
+        table.crc32c = MCF_crc32c_armv8;
+        table.crc32cMessages = MCF_crc32c_messages_armv8;
+        table.crc32cName = "armv8";
+    }
+#endif
+
+    MCF_dispatch = table;
+}
+
+#if defined(__GNUC__)
+__attribute__((constructor)) static void MCF_dispatch_startup(void)
+{
+    MCF_dispatch_init(MCF_CPU_ALL);
+}
+#endif
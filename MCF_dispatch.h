@@ -0,0 +1,71 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_DISPATCH_H_
+#define MULTICORE_FIFO_MCF_DISPATCH_H_
+
+#include "MCF.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** CPU features the dispatch layer can select on. */
+#define MCF_CPU_SSE4_2 (1u << 0)
+#define MCF_CPU_AVX2 (1u << 1)
+#define MCF_CPU_AVX512F (1u << 2)
+#define MCF_CPU_ARM_CRC32 (1u << 3)
+#define MCF_CPU_ALL 0xFFFFFFFFu
+
+/**
+ * @brief Kernel table shared by every SIMD-capable module.
+ *
+ * Each entry points to the best implementation of a kernel for the CPU the
+ * program runs on, so one binary serves a mixed fleet. The table is filled once
+ * by `MCF_dispatch_init()`; with GCC or Clang that happens automatically before
+ * `main()`, other compilers must call it at startup. Until then the portable
+ * implementations are used. Calls go through the pointers directly, so a kernel
+ * costs one indirect call and no feature test.
+ *
+ * - `features`: `MCF_CPU_*` bits detected and allowed.
+ * - `crc32c`: `MCF_crc32c()` kernel.
+ * - `crc32cMessages`: `MCF_crc32c_messages()` kernel.
+ * - `crc32cName`: Name of the selected CRC32C implementation.
+ */
+typedef struct
+{
+    uint32_t features;
+    uint32_t (*crc32c)(uint32_t Crc, const void *Data, size_t Length);
+    uint32_t (*crc32cMessages)(uint32_t Crc, const MCF_Message_t *Msgs, uint16_t count);
+    const char *crc32cName;
+} MCF_Dispatch_t;
+
+/** The kernel table. */
+extern MCF_Dispatch_t MCF_dispatch;
+
+/**
+ * @brief Detects the `MCF_CPU_*` features of the running CPU.
+ *
+ * Uses CPUID (and XGETBV, so AVX levels count only if the OS saves their
+ * registers) on x86 and the auxiliary vector on Linux/AArch64.
+ *
+ * @return The detected feature bits.
+ */
+uint32_t MCF_dispatch_detect(void);
+
+/**
+ * @brief Fills the kernel table for the running CPU.
+ *
+ * Not thread-safe: call it before other threads use MCF kernels.
+ *
+ * @param Mask Features that may be used, `MCF_CPU_ALL` normally; clear bits to
+ *             force lower levels, e.g. 0 for the portable implementations.
+ */
+void MCF_dispatch_init(uint32_t Mask);
+
+#endif /* MULTICORE_FIFO_MCF_DISPATCH_H_ */
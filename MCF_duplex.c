@@ -0,0 +1,171 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_duplex.h"
+#include "assert.h"
+#include <stddef.h>
+
+static inline uint16_t MCF_duplex_next(uint16_t index, uint16_t size)
+{
+    return (index >= size - 1) ? 0 : (uint16_t)(index + 1u);
+}
+
+/**
+ * @brief Takes a consumed count reported by the peer if it is ahead of the one
+ *        already known (published and piggybacked counts can cross).
+ *
+ * A valid ack lies in `(peerCount, txCount]`. An older one is a piggybacked ack at
+ * most a ring size behind, or the published line, which the peer refreshes before
+ * it lags `MCF_DUPLEX_REPUBLISH_LAG` behind. Either is more than 2^15 "ahead"
+ * modulo 2^16 and is ignored.
+ */
+static inline void MCF_duplex_ack(MCF_Duplex_t *Instance, uint16_t ack)
+{
+    uint16_t ahead = (uint16_t)(ack - Instance->peerCount);
+
+    if ((0u < ahead) && (ahead <= (uint16_t)(Instance->txCount - Instance->peerCount)))
+    {
+        Instance->peerCount = ack;
+    }
+}
+
+static inline int MCF_duplex_full(const MCF_Duplex_t *Instance)
+{
+    return (uint16_t)(Instance->txCount - Instance->peerCount) >= Instance->txSize - 1u;
+}
+
+/**
+ * @brief Writes a message with the piggybacked receive position and publishes it.
+ *
+ * The remote `ackCount` line is only read when the local view says the ring is full.
+ */
+static int MCF_duplex_push(MCF_Duplex_t *Instance, const MCF_Message_t *Msg)
+{
+    assert(NULL != Instance);
+
+    if (MCF_duplex_full(Instance))
+    {
+        MCF_duplex_ack(Instance, atomic_load_explicit(&Instance->txLink->ackCount, memory_order_acquire));
+        if (MCF_duplex_full(Instance))
+        {
+            return -1;
+        }
+    }
+
+    uint16_t head = MCF_duplex_next(Instance->txHead, Instance->txSize);
+
+    Instance->txBuf[head].msg = *Msg;
+    Instance->txBuf[head].ack = Instance->rxCount;
+    Instance->ackedCount = Instance->rxCount;
+    Instance->txHead = head;
+    Instance->txCount++;
+    atomic_store_explicit(&Instance->txLink->head, head, memory_order_release);
+    return 0;
+}
+
+void MCF_duplex_init(MCF_Duplex_t *Instance, MCF_DuplexLink_t *TxLink, MCF_DuplexSlot_t *TxBuf, uint16_t TxSize,
+                     MCF_DuplexLink_t *RxLink, MCF_DuplexSlot_t *RxBuf, uint16_t RxSize, uint16_t AckInterval,
+                     void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    assert((NULL != Instance) && (NULL != TxLink) && (NULL != TxBuf) && (1 < TxSize) && (TxSize <= 32768u) &&
+           (NULL != RxLink) && (NULL != RxBuf) && (1 < RxSize) && (RxSize <= 32768u) && (0 < AckInterval) &&
+           (AckInterval < RxSize) && (NULL != msgParser));
+
+    Instance->txLink = TxLink;
+    Instance->txBuf = TxBuf;
+    Instance->txSize = TxSize;
+    Instance->txHead = 0;
+    Instance->txCount = 0;
+    Instance->peerCount = 0;
+    Instance->rxLink = RxLink;
+    Instance->rxBuf = RxBuf;
+    Instance->rxSize = RxSize;
+    Instance->rxTail = 0;
+    Instance->rxCount = 0;
+    Instance->ackedCount = 0;
+    Instance->publishedCount = 0;
+    Instance->ackInterval = AckInterval;
+    Instance->msgParser = msgParser;
+    atomic_store_explicit(&TxLink->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&RxLink->ackCount, 0, memory_order_relaxed);
+}
+
+int MCF_duplex_send_u16(MCF_Duplex_t *Instance, uint16_t msgID, uint16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+
+    return MCF_duplex_push(Instance, &msg);
+}
+
+int MCF_duplex_send_i16(MCF_Duplex_t *Instance, uint16_t msgID, int16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+
+    return MCF_duplex_push(Instance, &msg);
+}
+
+int MCF_duplex_send_u32(MCF_Duplex_t *Instance, uint16_t msgID, uint32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+
+    return MCF_duplex_push(Instance, &msg);
+}
+
+int MCF_duplex_send_i32(MCF_Duplex_t *Instance, uint16_t msgID, int32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+
+    return MCF_duplex_push(Instance, &msg);
+}
+
+int MCF_duplex_send_f32(MCF_Duplex_t *Instance, uint16_t msgID, float value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+
+    return MCF_duplex_push(Instance, &msg);
+}
+
+void MCF_duplex_receive(MCF_Duplex_t *Instance)
+{
+    assert(NULL != Instance);
+
+    while (atomic_load_explicit(&Instance->rxLink->head, memory_order_acquire) != Instance->rxTail)
+    {
+        uint16_t tail = MCF_duplex_next(Instance->rxTail, Instance->rxSize);
+
+        /* Copied out: a reply sent from the parser acknowledges this slot. */
+        MCF_DuplexSlot_t slot = Instance->rxBuf[tail];
+
+        Instance->rxTail = tail;
+        Instance->rxCount++;
+        MCF_duplex_ack(Instance, slot.ack);
+        Instance->msgParser(&slot.msg);
+
+        /* Piggybacked replies reset ackedCount but leave the published line behind. */
+        if ((uint16_t)(Instance->rxCount - Instance->publishedCount) >= MCF_DUPLEX_REPUBLISH_LAG)
+        {
+            MCF_duplex_flush_ack(Instance);
+        }
+    }
+
+    if ((uint16_t)(Instance->rxCount - Instance->ackedCount) >= Instance->ackInterval)
+    {
+        MCF_duplex_flush_ack(Instance);
+    }
+}
+
+void MCF_duplex_flush_ack(MCF_Duplex_t *Instance)
+{
+    assert(NULL != Instance);
+
+    Instance->ackedCount = Instance->rxCount;
+    Instance->publishedCount = Instance->rxCount;
+    atomic_store_explicit(&Instance->rxLink->ackCount, Instance->rxCount, memory_order_release);
+}
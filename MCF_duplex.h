@@ -0,0 +1,174 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_DUPLEX_H_
+#define MULTICORE_FIFO_MCF_DUPLEX_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * Published acks are refreshed at least every this many consumed messages, even
+ * when every message was acknowledged by a piggybacked reply. A published count
+ * lagging less than 2^15 behind is never mistaken for a new one after the 16-bit
+ * counters wrap.
+ */
+#define MCF_DUPLEX_REPUBLISH_LAG 0x4000u
+
+/**
+ * @brief Shared indices of one direction of a duplex channel.
+ *
+ * - `head`: Last slot written, published by the sending side with every message.
+ * - `ackCount`: Messages consumed (free-running, wraps at 2^16), published by the
+ *   receiving side every `ackInterval` messages it could not piggyback and at least
+ *   every `MCF_DUPLEX_REPUBLISH_LAG` messages; the sender reads it only when its own
+ *   view says the ring is full.
+ */
+typedef struct
+{
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic uint16_t head;
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic uint16_t ackCount;
+} MCF_DuplexLink_t;
+
+/**
+ * @brief Slot of a duplex ring: the message plus the sender's receive position.
+ *
+ * `ack` is the number of messages the sender consumed from the opposite direction
+ * (free-running), so the peer learns how far its own messages were consumed from
+ * data it reads anyway.
+ */
+typedef struct
+{
+    MCF_Message_t msg;
+    uint16_t ack;
+} MCF_DuplexSlot_t;
+
+/**
+ * @brief One endpoint of a full-duplex channel.
+ *
+ * Each endpoint sends on one ring and receives on the other; the peer endpoint is
+ * initialized with the two rings swapped. Everything except the two links and the
+ * slots is private to the endpoint's core.
+ *
+ * Acknowledgements are free-running 16-bit message counts rather than slot
+ * indices: published and piggybacked acks can arrive out of order, and a count
+ * tells an old ack from a new one even when the ring is full, where a slot index
+ * one behind is indistinguishable from one a full ring ahead.
+ *
+ * - `txLink`, `txBuf`, `txSize`: Outgoing ring.
+ * - `txHead`: Local copy of the outgoing head.
+ * - `txCount`: Messages sent (free-running).
+ * - `peerCount`: Outgoing messages known to be consumed by the peer (free-running).
+ * - `rxLink`, `rxBuf`, `rxSize`: Incoming ring.
+ * - `rxTail`: Last incoming slot consumed.
+ * - `rxCount`: Incoming messages consumed (free-running).
+ * - `ackedCount`: Last `rxCount` made known to the peer (piggybacked or published).
+ * - `publishedCount`: Last `rxCount` stored in the incoming `ackCount` line.
+ * - `ackInterval`: Consumed messages after which `rxTail` is published if no
+ *   message carried it back.
+ * - `msgParser`: Callback invoked for every received message.
+ */
+typedef struct
+{
+    MCF_DuplexLink_t *txLink;
+    MCF_DuplexSlot_t *txBuf;
+    uint16_t txSize;
+    uint16_t txHead;
+    uint16_t txCount;
+    uint16_t peerCount;
+    MCF_DuplexLink_t *rxLink;
+    MCF_DuplexSlot_t *rxBuf;
+    uint16_t rxSize;
+    uint16_t rxTail;
+    uint16_t rxCount;
+    uint16_t ackedCount;
+    uint16_t publishedCount;
+    uint16_t ackInterval;
+    void (*msgParser)(MCF_Message_t *msgBuf);
+} MCF_Duplex_t;
+
+/**
+ * @brief Initializes one endpoint of a duplex channel.
+ *
+ * The peer calls this with `Tx*` and `Rx*` swapped. Each endpoint resets only the
+ * indices it publishes (its outgoing `head` and incoming `ackCount`).
+ *
+ * @param Instance    Pointer to the endpoint to initialize.
+ * @param TxLink      Indices of the outgoing ring.
+ * @param TxBuf       Slots of the outgoing ring.
+ * @param TxSize      Size of the outgoing ring (number of slots, at most 32768).
+ * @param RxLink      Indices of the incoming ring.
+ * @param RxBuf       Slots of the incoming ring.
+ * @param RxSize      Size of the incoming ring (number of slots, at most 32768).
+ * @param AckInterval Consumed messages after which the receive position is published
+ *                    when no reply carried it (1 to `RxSize - 1`).
+ * @param msgParser   Callback invoked for every received message.
+ */
+void MCF_duplex_init(MCF_Duplex_t *Instance, MCF_DuplexLink_t *TxLink, MCF_DuplexSlot_t *TxBuf, uint16_t TxSize,
+                     MCF_DuplexLink_t *RxLink, MCF_DuplexSlot_t *RxBuf, uint16_t RxSize, uint16_t AckInterval,
+                     void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Sends a uint16_t message to the peer.
+ *
+ * @param Instance Pointer to the endpoint.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return 0 on success, -1 when the outgoing ring is full (nothing is sent).
+ */
+int MCF_duplex_send_u16(MCF_Duplex_t *Instance, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Sends an int16_t message to the peer.
+ *
+ * @return 0 on success, -1 when the outgoing ring is full (nothing is sent).
+ */
+int MCF_duplex_send_i16(MCF_Duplex_t *Instance, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Sends a uint32_t message to the peer.
+ *
+ * @return 0 on success, -1 when the outgoing ring is full (nothing is sent).
+ */
+int MCF_duplex_send_u32(MCF_Duplex_t *Instance, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Sends an int32_t message to the peer.
+ *
+ * @return 0 on success, -1 when the outgoing ring is full (nothing is sent).
+ */
+int MCF_duplex_send_i32(MCF_Duplex_t *Instance, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Sends a float (float32) message to the peer.
+ *
+ * @return 0 on success, -1 when the outgoing ring is full (nothing is sent).
+ */
+int MCF_duplex_send_f32(MCF_Duplex_t *Instance, uint16_t msgID, float value);
+
+/**
+ * @brief Receives all pending messages from the peer and passes them to `msgParser`.
+ *
+ * Acknowledgements carried by the messages update the endpoint's view of the
+ * outgoing ring. Replies sent from the parser piggyback the receive position.
+ *
+ * @param Instance Pointer to the endpoint.
+ */
+void MCF_duplex_receive(MCF_Duplex_t *Instance);
+
+/**
+ * @brief Publishes the receive position now, e.g. before the endpoint goes idle.
+ *
+ * @param Instance Pointer to the endpoint.
+ */
+void MCF_duplex_flush_ack(MCF_Duplex_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_DUPLEX_H_ */
@@ -0,0 +1,124 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_edf.h"
+#include "assert.h"
+#include <stddef.h>
+
+static inline uint16_t MCF_edf_next(uint16_t index, uint16_t size)
+{
+    return (index >= size - 1) ? 0 : (uint16_t)(index + 1u);
+}
+
+/**
+ * @brief Counts the messages about to be dispatched that are already past their deadline.
+ */
+static void MCF_edf_account(MCF_EdfRing_t *Ring, uint16_t count, uint32_t now)
+{
+    uint16_t slot = *(Ring->ring->tail);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        slot = MCF_edf_next(slot, Ring->ring->msgBufSize);
+
+        int32_t lateness = (int32_t)(now - (Ring->stamps[slot] + Ring->budget));
+        if (0 < lateness)
+        {
+            Ring->misses++;
+            if ((uint32_t)lateness > Ring->maxLateness)
+            {
+                Ring->maxLateness = (uint32_t)lateness;
+            }
+        }
+    }
+}
+
+void MCF_edf_ring_init(MCF_EdfRing_t *Ring, MCF_t *Rx, uint32_t *Stamps, uint32_t Budget, uint16_t Quantum)
+{
+    assert((NULL != Ring) && (NULL != Rx) && (NULL != Stamps) && (0 < Quantum));
+
+    Ring->ring = Rx;
+    Ring->stamps = Stamps;
+    Ring->budget = Budget;
+    Ring->quantum = Quantum;
+    Ring->misses = 0;
+    Ring->maxLateness = 0;
+}
+
+void MCF_edf_init(MCF_Edf_t *Instance, MCF_EdfRing_t *Rings, uint8_t RingCount, uint32_t (*getTime)(void))
+{
+    assert((NULL != Instance) && (NULL != Rings) && (0 < RingCount) && (NULL != getTime));
+
+    Instance->rings = Rings;
+    Instance->ringCount = RingCount;
+    Instance->getTime = getTime;
+}
+
+void MCF_edf_stamp(const MCF_t *Tx, uint32_t *Stamps, uint32_t now)
+{
+    assert((NULL != Tx) && (NULL != Stamps));
+
+    Stamps[MCF_edf_next(*(Tx->head), Tx->msgBufSize)] = now;
+}
+
+uint16_t MCF_edf_run(MCF_Edf_t *Instance, uint16_t maxMessages)
+{
+    assert(NULL != Instance);
+
+    uint16_t dispatched = 0;
+
+    while (dispatched < maxMessages)
+    {
+        MCF_EdfRing_t *earliest = NULL;
+        uint32_t earliestDeadline = 0;
+        uint16_t earliestPending = 0;
+
+        for (uint8_t i = 0; i < Instance->ringCount; i++)
+        {
+            MCF_EdfRing_t *Ring = &Instance->rings[i];
+            uint16_t pending = MCF_get_pending(Ring->ring);
+
+            if (0u == pending)
+            {
+                continue;
+            }
+
+            uint16_t oldest = MCF_edf_next(*(Ring->ring->tail), Ring->ring->msgBufSize);
+            uint32_t deadline = Ring->stamps[oldest] + Ring->budget;
+
+            if ((NULL == earliest) || (0 > (int32_t)(deadline - earliestDeadline)))
+            {
+                earliest = Ring;
+                earliestDeadline = deadline;
+                earliestPending = pending;
+            }
+        }
+
+        if (NULL == earliest)
+        {
+            break;
+        }
+
+        uint16_t count = earliest->quantum;
+        if (count > earliestPending)
+        {
+            count = earliestPending;
+        }
+        if (count > (uint16_t)(maxMessages - dispatched))
+        {
+            count = (uint16_t)(maxMessages - dispatched);
+        }
+
+        MCF_edf_account(earliest, count, Instance->getTime());
+        dispatched = (uint16_t)(dispatched + MCF_receive_n(earliest->ring, count));
+    }
+
+    return dispatched;
+}
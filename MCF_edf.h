@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_EDF_H_
+#define MULTICORE_FIFO_MCF_EDF_H_
+
+#include "MCF.h"
+#include <stdint.h>
+
+/**
+ * @brief A consumer ring scheduled by deadline.
+ *
+ * The producer stamps every message with `MCF_edf_stamp()` just before sending it.
+ * The deadline of a ring is the stamp of its oldest message plus `budget`.
+ * Times are in any free-running 32-bit clock (cycle counter, timer ticks) shared
+ * by producer and consumer; comparisons are wrap-safe for differences below 2^31.
+ *
+ * - `ring`: Receiving MCF handle (its `msgParser` handles the messages).
+ * - `stamps`: Send time of every slot, `ring->msgBufSize` entries, shared with the producer.
+ * - `budget`: Latency budget: time a message may wait before it is late.
+ * - `quantum`: Maximum messages dispatched from this ring per scheduling decision.
+ * - `misses`: Messages dispatched after their deadline.
+ * - `maxLateness`: Largest lateness observed, in clock ticks.
+ */
+typedef struct
+{
+    MCF_t *ring;
+    uint32_t *stamps;
+    uint32_t budget;
+    uint16_t quantum;
+    uint32_t misses;
+    uint32_t maxLateness;
+} MCF_EdfRing_t;
+
+/**
+ * @brief Earliest-deadline-first scheduler over a set of rings.
+ *
+ * - `rings`: Scheduled rings.
+ * - `ringCount`: Number of rings.
+ * - `getTime`: Consumer's view of the clock used for the stamps.
+ */
+typedef struct
+{
+    MCF_EdfRing_t *rings;
+    uint8_t ringCount;
+    uint32_t (*getTime)(void);
+} MCF_Edf_t;
+
+/**
+ * @brief Initializes a scheduled ring.
+ *
+ * @param Ring    Pointer to the scheduled ring to initialize.
+ * @param Rx      Initialized receiving MCF handle.
+ * @param Stamps  Array of `Rx->msgBufSize` send times, shared with the producer.
+ * @param Budget  Latency budget of the ring, in clock ticks.
+ * @param Quantum Maximum messages per scheduling decision (at least 1).
+ */
+void MCF_edf_ring_init(MCF_EdfRing_t *Ring, MCF_t *Rx, uint32_t *Stamps, uint32_t Budget, uint16_t Quantum);
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * @param Instance  Pointer to the scheduler to initialize.
+ * @param Rings     Array of initialized scheduled rings.
+ * @param RingCount Number of rings.
+ * @param getTime   Clock the producers stamp with.
+ */
+void MCF_edf_init(MCF_Edf_t *Instance, MCF_EdfRing_t *Rings, uint8_t RingCount, uint32_t (*getTime)(void));
+
+/**
+ * @brief Records the send time of the next message; call right before `MCF_send_*()`.
+ *
+ * Producer side. Writes the stamp of the slot the next send will fill.
+ *
+ * @param Tx     Sending MCF handle of the ring.
+ * @param Stamps The ring's stamp array.
+ * @param now    Current time.
+ */
+void MCF_edf_stamp(const MCF_t *Tx, uint32_t *Stamps, uint32_t now);
+
+/**
+ * @brief Dispatches pending messages in earliest-deadline-first order.
+ *
+ * Repeatedly picks the non-empty ring whose oldest message has the earliest
+ * deadline and parses up to its `quantum` messages, until all rings are empty or
+ * `maxMessages` were parsed. Under overload the bound keeps the call short, and
+ * rings with tight budgets are still served first.
+ *
+ * @param Instance    Pointer to the scheduler.
+ * @param maxMessages Maximum number of messages to parse in this call.
+ * @return Number of messages parsed.
+ */
+uint16_t MCF_edf_run(MCF_Edf_t *Instance, uint16_t maxMessages);
+
+#endif /* MULTICORE_FIFO_MCF_EDF_H_ */
@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_elastic.h"
+#include "assert.h"
+#include <stddef.h>
+
+/**
+ * @brief Publishes a new consumer count and records the event.
+ */
+static void MCF_elastic_scale(MCF_Elastic_t *Instance, unsigned int active, uint32_t backlog, uint32_t now)
+{
+    atomic_store_explicit(&Instance->active, active, memory_order_release);
+    Instance->trend = 0;
+    Instance->metrics.lastEventTime = now;
+    Instance->metrics.lastEventBacklog = backlog;
+    if (active > Instance->metrics.peakConsumers)
+    {
+        Instance->metrics.peakConsumers = (uint8_t)active;
+    }
+    if (NULL != Instance->config.onScale)
+    {
+        Instance->config.onScale((uint8_t)active);
+    }
+}
+
+void MCF_elastic_init(MCF_Elastic_t *Instance, const MCF_ElasticConfig_t *Config)
+{
+    assert((NULL != Instance) && (NULL != Config) && (NULL != Config->getBacklog) && (NULL != Config->getTime) &&
+           (0 < Config->minConsumers) && (Config->minConsumers <= Config->maxConsumers) &&
+           (Config->downBacklog < Config->upBacklog));
+
+    Instance->config = *Config;
+    atomic_init(&Instance->active, Config->minConsumers);
+    Instance->trend = 0;
+    Instance->trendSince = 0;
+    Instance->metrics = (MCF_ElasticMetrics_t){.peakConsumers = Config->minConsumers};
+}
+
+int MCF_elastic_poll(MCF_Elastic_t *Instance)
+{
+    assert(NULL != Instance);
+
+    const MCF_ElasticConfig_t *config = &Instance->config;
+    unsigned int active = atomic_load_explicit(&Instance->active, memory_order_relaxed);
+    uint32_t backlog = config->getBacklog();
+    uint32_t now = config->getTime();
+    int8_t trend = 0;
+
+    if (backlog > Instance->metrics.peakBacklog)
+    {
+        Instance->metrics.peakBacklog = backlog;
+    }
+
+    /* 64-bit products: thresholds times consumers may exceed 32 bits. */
+    if ((uint64_t)backlog > (uint64_t)config->upBacklog * active)
+    {
+        trend = (active < config->maxConsumers) ? 1 : 0;
+    }
+    else if ((uint64_t)backlog <= (uint64_t)config->downBacklog * active)
+    {
+        trend = (active > config->minConsumers) ? -1 : 0;
+    }
+
+    if (trend != Instance->trend)
+    {
+        Instance->trend = trend;
+        Instance->trendSince = now;
+        return 0;
+    }
+
+    if ((1 == trend) && ((uint32_t)(now - Instance->trendSince) >= config->upDwell))
+    {
+        Instance->metrics.scaleUps++;
+        MCF_elastic_scale(Instance, active + 1u, backlog, now);
+        return 1;
+    }
+    if ((-1 == trend) && ((uint32_t)(now - Instance->trendSince) >= config->downDwell))
+    {
+        Instance->metrics.scaleDowns++;
+        MCF_elastic_scale(Instance, active - 1u, backlog, now);
+        return -1;
+    }
+    return 0;
+}
+
+int MCF_elastic_is_active(const MCF_Elastic_t *Instance, uint8_t consumer)
+{
+    assert(NULL != Instance);
+
+    return consumer < atomic_load_explicit(&Instance->active, memory_order_acquire);
+}
+
+uint8_t MCF_elastic_get_active(const MCF_Elastic_t *Instance)
+{
+    assert(NULL != Instance);
+
+    return (uint8_t)atomic_load_explicit(&Instance->active, memory_order_acquire);
+}
@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_ELASTIC_H_
+#define MULTICORE_FIFO_MCF_ELASTIC_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief Scaling policy of an elastic consumer pool.
+ *
+ * Backlog thresholds are per active consumer. A scale-up needs the backlog above
+ * `upBacklog * active` for `upDwell` clock ticks in a row, a scale-down needs it
+ * at or below `downBacklog * active` for `downDwell`. The gap between the
+ * thresholds and the dwell times keep the pool from thrashing around one load
+ * level. After every scale event the dwell starts over, so the pool changes one
+ * consumer at a time.
+ *
+ * - `getBacklog`: Returns the messages waiting in the channel (e.g. `MCF_mpmc_get_pending()`).
+ * - `getTime`: Free-running 32-bit clock the dwell times are measured in.
+ * - `onScale`: Called by `MCF_elastic_poll()` with the new number of active consumers,
+ *   to wake parked consumer threads or start new ones. May be NULL.
+ * - `minConsumers`, `maxConsumers`: Bounds of the active consumer count.
+ * - `upBacklog`: Backlog per active consumer above which the pool grows.
+ * - `downBacklog`: Backlog per active consumer at or below which the pool shrinks (less than `upBacklog`).
+ * - `upDwell`, `downDwell`: Time a threshold must be crossed before acting.
+ */
+typedef struct
+{
+    uint32_t (*getBacklog)(void);
+    uint32_t (*getTime)(void);
+    void (*onScale)(uint8_t active);
+    uint8_t minConsumers;
+    uint8_t maxConsumers;
+    uint32_t upBacklog;
+    uint32_t downBacklog;
+    uint32_t upDwell;
+    uint32_t downDwell;
+} MCF_ElasticConfig_t;
+
+/**
+ * @brief Scale event counters, updated by `MCF_elastic_poll()`.
+ *
+ * - `scaleUps`, `scaleDowns`: Number of scale events in each direction.
+ * - `peakBacklog`: Largest backlog seen by the supervisor.
+ * - `peakConsumers`: Largest active consumer count reached.
+ * - `lastEventTime`: Clock value of the latest scale event.
+ * - `lastEventBacklog`: Backlog that triggered the latest scale event.
+ */
+typedef struct
+{
+    uint32_t scaleUps;
+    uint32_t scaleDowns;
+    uint32_t peakBacklog;
+    uint8_t peakConsumers;
+    uint32_t lastEventTime;
+    uint32_t lastEventBacklog;
+} MCF_ElasticMetrics_t;
+
+/**
+ * @brief Supervisor sizing a pool of consumer threads to the backlog of a channel.
+ *
+ * The pool itself belongs to the application: consumer `i` keeps draining while
+ * `MCF_elastic_is_active()` says so and parks otherwise, `onScale` wakes it again.
+ * This keeps the supervisor free of any thread API.
+ *
+ * - `config`: Scaling policy.
+ * - `active`: Number of consumers that should run, read by the consumer threads.
+ * - `trend`: Threshold crossed at the previous poll: 1 above, -1 below, 0 none.
+ * - `trendSince`: Time the current trend started.
+ * - `metrics`: Scale event counters.
+ */
+typedef struct
+{
+    MCF_ElasticConfig_t config;
+    _Alignas(MCF_CACHE_LINE_SIZE) atomic_uint active;
+    _Alignas(MCF_CACHE_LINE_SIZE) int8_t trend;
+    uint32_t trendSince;
+    MCF_ElasticMetrics_t metrics;
+} MCF_Elastic_t;
+
+/**
+ * @brief Initializes the supervisor with `minConsumers` active consumers.
+ *
+ * @param Instance Pointer to the supervisor to initialize.
+ * @param Config   Scaling policy, copied into the supervisor.
+ */
+void MCF_elastic_init(MCF_Elastic_t *Instance, const MCF_ElasticConfig_t *Config);
+
+/**
+ * @brief Samples the backlog and adds or parks one consumer when the policy says so.
+ *
+ * Call periodically from one supervisor thread (or timer), well below the dwell times.
+ *
+ * @param Instance Pointer to the supervisor.
+ * @return 1 after a scale-up, -1 after a scale-down, 0 otherwise.
+ */
+int MCF_elastic_poll(MCF_Elastic_t *Instance);
+
+/**
+ * @brief Tells a consumer thread whether it should keep draining.
+ *
+ * Consumers are numbered 0 to `maxConsumers - 1`; the lowest `active` of them run.
+ *
+ * @param Instance Pointer to the supervisor.
+ * @param consumer Index of the calling consumer.
+ * @return Non-zero if the consumer should run, 0 if it should park.
+ */
+int MCF_elastic_is_active(const MCF_Elastic_t *Instance, uint8_t consumer);
+
+/**
+ * @brief Returns the number of consumers that should currently run.
+ *
+ * @param Instance Pointer to the supervisor.
+ * @return Active consumer count.
+ */
+uint8_t MCF_elastic_get_active(const MCF_Elastic_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_ELASTIC_H_ */
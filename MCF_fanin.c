@@ -0,0 +1,162 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_fanin.h"
+#include "assert.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * @brief Copies as many messages from `Child` to `Up` as both allow.
+ *
+ * The combiner is the consumer of `Child` and the producer of `Up`, so it writes
+ * the child's tail and the parent ring's head, each once per batch.
+ */
+static uint16_t MCF_fanin_move(MCF_t *Child, MCF_t *Up)
+{
+    uint16_t count = MCF_get_pending(Child);
+    uint16_t room = MCF_get_free(Up);
+
+    if (room < count)
+    {
+        count = room;
+    }
+    if (0u == count)
+    {
+        return 0;
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+
+    uint16_t tail = *(Child->tail);
+    uint16_t head = *(Up->head);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        tail = (tail >= Child->msgBufSize - 1) ? 0 : (uint16_t)(tail + 1u);
+        head = (head >= Up->msgBufSize - 1) ? 0 : (uint16_t)(head + 1u);
+        Up->msgBuf[head] = Child->msgBuf[tail];
+    }
+
+    atomic_thread_fence(memory_order_release);
+    *(Up->head) = head;
+    *(Child->tail) = tail;
+    return count;
+}
+
+uint16_t MCF_fanin_node_count(uint16_t Producers, uint16_t Fanout)
+{
+    assert((0 < Producers) && (2 <= Fanout));
+
+    uint32_t nodes = 0;
+    uint32_t count = Producers;
+
+    while (count > Fanout)
+    {
+        count = (count + Fanout - 1u) / Fanout;
+        nodes += count;
+    }
+
+    /* Rings are addressed with 16-bit indices. */
+    assert((uint32_t)Producers + nodes <= UINT16_MAX);
+    return (uint16_t)nodes;
+}
+
+void MCF_fanin_init(MCF_Fanin_t *Instance, MCF_t *Rings, MCF_Indices_t *Indices, MCF_Message_t *MsgBufs,
+                    uint16_t Producers, uint16_t Fanout, uint16_t LeafSize, uint16_t NodeSize,
+                    void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    assert((NULL != Instance) && (NULL != Rings) && (NULL != Indices) && (NULL != MsgBufs) && (0 < Producers) &&
+           (2 <= Fanout) && (1 < LeafSize) && (1 < NodeSize) && (NULL != msgParser));
+
+    uint16_t nodes = MCF_fanin_node_count(Producers, Fanout);
+    MCF_Message_t *msgBuf = MsgBufs;
+
+    for (uint32_t i = 0; i < (uint32_t)Producers + nodes; i++)
+    {
+        uint16_t size = (i < Producers) ? LeafSize : NodeSize;
+
+        MCF_init_RXTX(&Rings[i], &Indices[i].head, &Indices[i].tail, msgBuf, size, msgParser);
+        msgBuf += size;
+    }
+
+    Instance->rings = Rings;
+    Instance->producers = Producers;
+    Instance->nodes = nodes;
+    Instance->fanout = Fanout;
+    Instance->levels = 0;
+    Instance->levelStart[0] = 0;
+    Instance->levelCount[0] = Producers;
+
+    while (Instance->levelCount[Instance->levels] > Fanout)
+    {
+        uint8_t level = Instance->levels;
+
+        assert(MCF_FANIN_MAX_LEVELS > level);
+        Instance->levelStart[level + 1u] = (uint16_t)(Instance->levelStart[level] + Instance->levelCount[level]);
+        Instance->levelCount[level + 1u] = (uint16_t)((Instance->levelCount[level] + Fanout - 1u) / Fanout);
+        Instance->levels++;
+    }
+}
+
+MCF_t *MCF_fanin_producer(MCF_Fanin_t *Instance, uint16_t producer)
+{
+    assert((NULL != Instance) && (producer < Instance->producers));
+
+    return &Instance->rings[producer];
+}
+
+uint16_t MCF_fanin_combine(MCF_Fanin_t *Instance, uint16_t node)
+{
+    assert((NULL != Instance) && (node < Instance->nodes));
+
+    uint16_t ring = (uint16_t)(Instance->producers + node);
+    uint8_t level = 1;
+
+    while ((level < Instance->levels) && (ring >= Instance->levelStart[level + 1u]))
+    {
+        level++;
+    }
+
+    uint16_t index = (uint16_t)(ring - Instance->levelStart[level]);
+    uint16_t first = (uint16_t)(Instance->levelStart[level - 1u] + index * Instance->fanout);
+    uint16_t end = (uint16_t)(Instance->levelStart[level - 1u] + Instance->levelCount[level - 1u]);
+    uint16_t moved = 0;
+
+    if (end > first + Instance->fanout)
+    {
+        end = (uint16_t)(first + Instance->fanout);
+    }
+    for (uint16_t child = first; child < end; child++)
+    {
+        moved = (uint16_t)(moved + MCF_fanin_move(&Instance->rings[child], &Instance->rings[ring]));
+    }
+    return moved;
+}
+
+void MCF_fanin_receive(MCF_Fanin_t *Instance)
+{
+    assert(NULL != Instance);
+
+    uint16_t first = Instance->levelStart[Instance->levels];
+
+    for (uint16_t i = 0; i < Instance->levelCount[Instance->levels]; i++)
+    {
+        MCF_t *Ring = &Instance->rings[first + i];
+        uint16_t pending = MCF_get_pending(Ring);
+
+        /* Pairs with the release fence of MCF_send_batch() or MCF_fanin_move(). */
+        if (0u != pending)
+        {
+            atomic_thread_fence(memory_order_acquire);
+            MCF_receive_n(Ring, pending);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_FANIN_H_
+#define MULTICORE_FIFO_MCF_FANIN_H_
+
+#include "MCF.h"
+#include <stdint.h>
+
+/** Maximum number of combiner levels (fan-out 2 with 32767 producers needs 14). */
+#define MCF_FANIN_MAX_LEVELS 16u
+
+/**
+ * @brief Fan-in tree of MCF rings for many producers and one consumer.
+ *
+ * Every producer owns a leaf ring. Combiner nodes each drain up to `fanout` rings
+ * of the level below into their own upstream ring, one batch per child, so the
+ * consumer only polls the at most `fanout` rings of the top level however many
+ * producers there are. Combiners are run by whichever threads the application
+ * dedicates to them (`MCF_fanin_combine()`), a node by one thread at a time.
+ * Order is kept per producer.
+ *
+ * Rings are numbered leaves first (`0` to `producers - 1`), then combiner outputs
+ * level by level; node `n` owns ring `producers + n`. Ring numbers are 16-bit, so
+ * producers plus nodes must not exceed 65535: about 32K producers at fan-out 2,
+ * more with a wider fan-out.
+ *
+ * - `rings`: All leaf and combiner rings.
+ * - `producers`: Number of leaf rings.
+ * - `nodes`: Number of combiner nodes.
+ * - `fanout`: Rings drained by one combiner node, and polled by the consumer.
+ * - `levels`: Number of combiner levels (0 when `producers <= fanout`).
+ * - `levelStart`: First ring of each level, level 0 being the leaves.
+ * - `levelCount`: Number of rings of each level.
+ */
+typedef struct
+{
+    MCF_t *rings;
+    uint16_t producers;
+    uint16_t nodes;
+    uint16_t fanout;
+    uint8_t levels;
+    uint16_t levelStart[MCF_FANIN_MAX_LEVELS + 1u];
+    uint16_t levelCount[MCF_FANIN_MAX_LEVELS + 1u];
+} MCF_Fanin_t;
+
+/**
+ * @brief Returns the number of combiner nodes of a tree, to size its storage.
+ *
+ * `Producers` plus the returned count must not exceed 65535.
+ *
+ * @param Producers Number of producers.
+ * @param Fanout    Children per combiner node (at least 2).
+ */
+uint16_t MCF_fanin_node_count(uint16_t Producers, uint16_t Fanout);
+
+/**
+ * @brief Initializes a fan-in tree.
+ *
+ * With `N = MCF_fanin_node_count(Producers, Fanout)`, `Rings` and `Indices` hold
+ * `Producers + N` elements and `MsgBufs` holds `Producers * LeafSize + N * NodeSize`
+ * messages. A node ring should be at least a few leaf batches large.
+ *
+ * @param Instance  Pointer to the tree to initialize.
+ * @param Rings     MCF handles of all rings.
+ * @param Indices   Head/tail pairs of all rings.
+ * @param MsgBufs   Message storage of all rings.
+ * @param Producers Number of producers (leaf rings).
+ * @param Fanout    Children per combiner node (at least 2).
+ * @param LeafSize  Size of each producer ring (number of messages).
+ * @param NodeSize  Size of each combiner output ring (number of messages).
+ * @param msgParser Callback invoked by the consumer for every message.
+ */
+void MCF_fanin_init(MCF_Fanin_t *Instance, MCF_t *Rings, MCF_Indices_t *Indices, MCF_Message_t *MsgBufs,
+                    uint16_t Producers, uint16_t Fanout, uint16_t LeafSize, uint16_t NodeSize,
+                    void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Returns the leaf ring of a producer, to be used with `MCF_send_batch()`.
+ *
+ * `MCF_send_batch()` publishes the head after a release fence, which the combiner's
+ * acquire pairs with, and never overwrites unread messages (it returns how many
+ * fit). The plain `MCF_send_*()` do not order the payload before the head for a
+ * combiner running on another core.
+ *
+ * @param Instance Pointer to the tree.
+ * @param producer Producer index (0 to `producers - 1`).
+ */
+MCF_t *MCF_fanin_producer(MCF_Fanin_t *Instance, uint16_t producer);
+
+/**
+ * @brief Moves pending messages of one node's children into the node's ring.
+ *
+ * Each child is drained as far as the node ring has room, and both rings are
+ * published once per child batch. Never overwrites: when the node ring is full,
+ * the rest stays in the children.
+ *
+ * @param Instance Pointer to the tree.
+ * @param node     Combiner node (0 to `nodes - 1`).
+ * @return Number of messages moved.
+ */
+uint16_t MCF_fanin_combine(MCF_Fanin_t *Instance, uint16_t node);
+
+/**
+ * @brief Drains the top-level rings into `msgParser`.
+ *
+ * Must only be called by the single consumer.
+ *
+ * @param Instance Pointer to the tree.
+ */
+void MCF_fanin_receive(MCF_Fanin_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_FANIN_H_ */
@@ -0,0 +1,195 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Slots are written like a sequence lock: the writer invalidates the tag, stores
+ * the data and then tags the slot with its offset. A reader loads the tag, the
+ * data and the tag again; the copy is only valid if both tags equal the offset it
+ * wanted, otherwise the writer has lapped it.
+ */
+
+#include "MCF_log.h"
+#include "assert.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(sizeof(MCF_Message_t) == sizeof(uint64_t), "MCF_log stores a message in one 64-bit word");
+
+static uint64_t MCF_log_append(MCF_Log_t *Instance, const MCF_Message_t *Msg)
+{
+    assert(NULL != Instance);
+
+    uint64_t offset = atomic_load_explicit(&Instance->end, memory_order_relaxed);
+    MCF_LogSlot_t *slot = &Instance->slots[offset & (Instance->capacity - 1u)];
+    uint64_t data;
+
+    memcpy(&data, Msg, sizeof(data));
+
+    atomic_store_explicit(&slot->tag, MCF_LOG_NO_OFFSET, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+    atomic_store_explicit(&slot->tag, offset, memory_order_release);
+    atomic_store_explicit(&Instance->end, offset + 1u, memory_order_release);
+    return offset;
+}
+
+/**
+ * @brief Moves a lapped reader to the oldest retained offset.
+ */
+static void MCF_log_skip(MCF_LogReader_t *Reader)
+{
+    uint64_t start = MCF_log_start_offset(Reader->log);
+
+    if (start > Reader->offset)
+    {
+        Reader->lost += start - Reader->offset;
+        Reader->offset = start;
+    }
+    else
+    {
+        /* Lost the race for the oldest slot itself. */
+        Reader->lost++;
+        Reader->offset++;
+    }
+}
+
+void MCF_log_init(MCF_Log_t *Instance, MCF_LogSlot_t *Slots, uint32_t Capacity)
+{
+    assert((NULL != Instance) && (NULL != Slots) && (2u <= Capacity) && (0u == (Capacity & (Capacity - 1u))));
+
+    for (uint32_t i = 0; i < Capacity; i++)
+    {
+        atomic_init(&Slots[i].tag, MCF_LOG_NO_OFFSET);
+        atomic_init(&Slots[i].data, 0u);
+    }
+    Instance->slots = Slots;
+    Instance->capacity = Capacity;
+    atomic_init(&Instance->end, 0u);
+}
+
+uint64_t MCF_log_append_u16(MCF_Log_t *Instance, uint16_t msgID, uint16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+
+    return MCF_log_append(Instance, &msg);
+}
+
+uint64_t MCF_log_append_i16(MCF_Log_t *Instance, uint16_t msgID, int16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+
+    return MCF_log_append(Instance, &msg);
+}
+
+uint64_t MCF_log_append_u32(MCF_Log_t *Instance, uint16_t msgID, uint32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+
+    return MCF_log_append(Instance, &msg);
+}
+
+uint64_t MCF_log_append_i32(MCF_Log_t *Instance, uint16_t msgID, int32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+
+    return MCF_log_append(Instance, &msg);
+}
+
+uint64_t MCF_log_append_f32(MCF_Log_t *Instance, uint16_t msgID, float value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+
+    return MCF_log_append(Instance, &msg);
+}
+
+uint64_t MCF_log_end_offset(const MCF_Log_t *Instance)
+{
+    assert(NULL != Instance);
+
+    return atomic_load_explicit(&Instance->end, memory_order_acquire);
+}
+
+uint64_t MCF_log_start_offset(const MCF_Log_t *Instance)
+{
+    uint64_t end = MCF_log_end_offset(Instance);
+
+    return (end > Instance->capacity) ? end - Instance->capacity : 0u;
+}
+
+void MCF_log_reader_init(MCF_LogReader_t *Reader, const MCF_Log_t *Log, uint64_t Offset,
+                         void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    assert((NULL != Reader) && (NULL != Log));
+
+    Reader->log = Log;
+    Reader->offset = Offset;
+    Reader->lost = 0;
+    Reader->msgParser = msgParser;
+}
+
+void MCF_log_seek(MCF_LogReader_t *Reader, uint64_t Offset)
+{
+    assert(NULL != Reader);
+
+    Reader->offset = Offset;
+}
+
+int MCF_log_read(MCF_LogReader_t *Reader, MCF_Message_t *Msg)
+{
+    assert((NULL != Reader) && (NULL != Msg));
+
+    const MCF_Log_t *log = Reader->log;
+    uint64_t offset = Reader->offset;
+    uint64_t end = MCF_log_end_offset(log);
+
+    if (offset >= end)
+    {
+        return 0;
+    }
+    if (end - offset > log->capacity)
+    {
+        MCF_log_skip(Reader);
+        return -1;
+    }
+
+    MCF_LogSlot_t *slot = &log->slots[offset & (log->capacity - 1u)];
+    uint64_t before = atomic_load_explicit(&slot->tag, memory_order_acquire);
+    uint64_t data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    if ((offset != before) || (offset != atomic_load_explicit(&slot->tag, memory_order_relaxed)))
+    {
+        MCF_log_skip(Reader);
+        return -1;
+    }
+
+    memcpy(Msg, &data, sizeof(data));
+    Reader->offset = offset + 1u;
+    return 1;
+}
+
+uint32_t MCF_log_receive(MCF_LogReader_t *Reader)
+{
+    assert((NULL != Reader) && (NULL != Reader->msgParser));
+
+    uint32_t received = 0;
+    MCF_Message_t msg;
+    int status;
+
+    while (0 != (status = MCF_log_read(Reader, &msg)))
+    {
+        if (1 == status)
+        {
+            Reader->msgParser(&msg);
+            received++;
+        }
+    }
+    return received;
+}
@@ -0,0 +1,191 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_LOG_H_
+#define MULTICORE_FIFO_MCF_LOG_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief One retained message and the offset it was written at.
+ *
+ * Both words are atomics so readers can copy a slot while the writer overwrites
+ * it; `tag` tells a complete copy from a torn one.
+ *
+ * - `tag`: Offset of the message in `data`, `MCF_LOG_NO_OFFSET` while being written.
+ * - `data`: The `MCF_Message_t`, as one 64-bit word.
+ */
+typedef struct
+{
+    _Atomic uint64_t tag;
+    _Atomic uint64_t data;
+} MCF_LogSlot_t;
+
+/** Tag of a slot that is empty or being written. */
+#define MCF_LOG_NO_OFFSET UINT64_MAX
+
+/**
+ * @brief Retained message log with a single writer and any number of readers.
+ *
+ * Unlike an MCF ring, reading does not consume: every message gets a 64-bit
+ * offset and stays in the log until the writer wraps over it, so the last
+ * `capacity` messages can be replayed by readers that join late. The writer
+ * never waits for readers; a reader that falls more than `capacity` behind is
+ * lapped, which it detects and reports.
+ *
+ * Requires lock-free 64-bit atomics (64-bit hosts, AArch64/ARMv7-A with LDREXD).
+ *
+ * - `slots`: Message storage, `capacity` slots.
+ * - `capacity`: Number of retained messages, a power of two.
+ * - `end`: Offset the next message will be written at.
+ */
+typedef struct
+{
+    MCF_LogSlot_t *slots;
+    uint32_t capacity;
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic uint64_t end;
+} MCF_Log_t;
+
+/**
+ * @brief A reader's position in a log. Each reader owns its own.
+ *
+ * - `log`: Log being read.
+ * - `offset`: Offset of the next message to read.
+ * - `lost`: Messages skipped because the writer lapped the reader.
+ * - `msgParser`: Callback invoked by `MCF_log_receive()` for every message.
+ */
+typedef struct
+{
+    const MCF_Log_t *log;
+    uint64_t offset;
+    uint64_t lost;
+    void (*msgParser)(MCF_Message_t *msgBuf);
+} MCF_LogReader_t;
+
+/**
+ * @brief Initializes an empty log.
+ *
+ * @param Instance Pointer to the log to initialize.
+ * @param Slots    Storage of `Capacity` slots.
+ * @param Capacity Number of retained messages (a power of two, at least 2).
+ */
+void MCF_log_init(MCF_Log_t *Instance, MCF_LogSlot_t *Slots, uint32_t Capacity);
+
+/**
+ * @brief Appends a uint16_t message. Writer only; never blocks.
+ *
+ * @param Instance Pointer to the log.
+ * @param msgID    Identifier of the message.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return Offset of the appended message.
+ */
+uint64_t MCF_log_append_u16(MCF_Log_t *Instance, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Appends an int16_t message. Writer only; never blocks.
+ *
+ * @param Instance Pointer to the log.
+ * @param msgID    Identifier of the message.
+ * @param value    16-bit signed value to include in the message payload.
+ * @return Offset of the appended message.
+ */
+uint64_t MCF_log_append_i16(MCF_Log_t *Instance, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Appends a uint32_t message. Writer only; never blocks.
+ *
+ * @param Instance Pointer to the log.
+ * @param msgID    Identifier of the message.
+ * @param value    32-bit unsigned value to include in the message payload.
+ * @return Offset of the appended message.
+ */
+uint64_t MCF_log_append_u32(MCF_Log_t *Instance, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Appends an int32_t message. Writer only; never blocks.
+ *
+ * @param Instance Pointer to the log.
+ * @param msgID    Identifier of the message.
+ * @param value    32-bit signed value to include in the message payload.
+ * @return Offset of the appended message.
+ */
+uint64_t MCF_log_append_i32(MCF_Log_t *Instance, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Appends a float message. Writer only; never blocks.
+ *
+ * @param Instance Pointer to the log.
+ * @param msgID    Identifier of the message.
+ * @param value    Floating-point value to include in the message payload.
+ * @return Offset of the appended message.
+ */
+uint64_t MCF_log_append_f32(MCF_Log_t *Instance, uint16_t msgID, float value);
+
+/**
+ * @brief Returns the offset the next message will be written at.
+ *
+ * @param Instance Pointer to the log.
+ */
+uint64_t MCF_log_end_offset(const MCF_Log_t *Instance);
+
+/**
+ * @brief Returns the offset of the oldest message still retained.
+ *
+ * The writer may overwrite it at any moment; readers seeking to it must still
+ * expect to be lapped.
+ *
+ * @param Instance Pointer to the log.
+ */
+uint64_t MCF_log_start_offset(const MCF_Log_t *Instance);
+
+/**
+ * @brief Initializes a reader.
+ *
+ * @param Reader    Pointer to the reader to initialize.
+ * @param Log       Log to read.
+ * @param Offset    Offset to start at, e.g. `MCF_log_start_offset()` to replay
+ *                  everything retained or `MCF_log_end_offset()` for new messages only.
+ * @param msgParser Callback for `MCF_log_receive()`; may be NULL if only `MCF_log_read()` is used.
+ */
+void MCF_log_reader_init(MCF_LogReader_t *Reader, const MCF_Log_t *Log, uint64_t Offset,
+                         void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Moves a reader to another offset, backwards (replay) or forwards.
+ *
+ * @param Reader Pointer to the reader.
+ * @param Offset Offset of the next message to read.
+ */
+void MCF_log_seek(MCF_LogReader_t *Reader, uint64_t Offset);
+
+/**
+ * @brief Reads the message at the reader's offset and advances it.
+ *
+ * @param Reader Pointer to the reader.
+ * @param Msg    Receives the message.
+ * @return 1 if a message was read, 0 if the reader is at the end of the log,
+ *         -1 if the message was overwritten; the reader then moved to the oldest
+ *         retained offset and added the skipped messages to `lost`.
+ */
+int MCF_log_read(MCF_LogReader_t *Reader, MCF_Message_t *Msg);
+
+/**
+ * @brief Reads messages up to the end of the log and passes each to `msgParser`.
+ *
+ * Laps are skipped and counted in `lost`.
+ *
+ * @param Reader Pointer to the reader.
+ * @return Number of messages parsed.
+ */
+uint32_t MCF_log_receive(MCF_LogReader_t *Reader);
+
+#endif /* MULTICORE_FIFO_MCF_LOG_H_ */
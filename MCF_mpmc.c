@@ -0,0 +1,295 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Index rings follow the scalable circular queue (SCQ) of Nikolaev, "A Scalable,
+ * Portable, and Memory-Efficient Lock-Free FIFO Queue" (DISC 2019).
+ *
+ * A ring of capacity n = 2^order has 2n entries. An entry packs, from the least
+ * significant bit: the slot index (order + 1 bits, all ones meaning "empty"),
+ * the safe bit and the cycle, i.e. the lap of the head/tail counter it was
+ * written in. Counters are 64-bit and never wrap in practice.
+ */
+
+#include "MCF_mpmc.h"
+#include "assert.h"
+#include <stddef.h>
+
+/** Entries per cache line; consecutive positions are spread over different lines. */
+#define MCF_MPMC_LINE_ENTRIES (MCF_CACHE_LINE_SIZE / sizeof(uint64_t))
+
+static inline uint64_t MCF_mpmc_empty(uint8_t order)
+{
+    return (2ull << order) - 1u;
+}
+
+static inline uint64_t MCF_mpmc_safe(uint8_t order)
+{
+    return 2ull << order;
+}
+
+static inline uint64_t MCF_mpmc_entry_cycle(uint64_t entry, uint8_t order)
+{
+    return entry >> (order + 2u);
+}
+
+static inline uint64_t MCF_mpmc_pos_cycle(uint64_t pos, uint8_t order)
+{
+    return pos >> (order + 1u);
+}
+
+static inline uint64_t MCF_mpmc_entry(uint64_t cycle, uint64_t safe, uint64_t index, uint8_t order)
+{
+    return (cycle << (order + 2u)) | safe | index;
+}
+
+/**
+ * @brief Maps a position to an entry so neighbouring positions, claimed by
+ *        different threads at the same time, do not share a cache line.
+ */
+static inline size_t MCF_mpmc_remap(uint64_t pos, uint8_t order)
+{
+    uint64_t size = 2ull << order;
+    uint64_t lines = size / MCF_MPMC_LINE_ENTRIES;
+
+    pos &= size - 1u;
+    if (1u >= lines)
+    {
+        return (size_t)pos;
+    }
+    return (size_t)(((pos % MCF_MPMC_LINE_ENTRIES) * lines) + (pos / MCF_MPMC_LINE_ENTRIES));
+}
+
+static void MCF_mpmc_ring_init(MCF_MpmcRing_t *Ring, _Atomic uint64_t *Entries, uint8_t order, int full)
+{
+    uint64_t capacity = 1ull << order;
+    uint64_t size = 2u * capacity;
+
+    for (uint64_t pos = 0; pos < size; pos++)
+    {
+        uint64_t entry = MCF_mpmc_entry(0, MCF_mpmc_safe(order), MCF_mpmc_empty(order), order);
+
+        if (full && (pos < capacity))
+        {
+            entry = MCF_mpmc_entry(1, MCF_mpmc_safe(order), pos, order);
+        }
+        atomic_init(&Entries[MCF_mpmc_remap(pos, order)], entry);
+    }
+
+    /* Counters start at lap 1 so the lap 0 entries above read as stale. */
+    Ring->entries = Entries;
+    atomic_init(&Ring->head, size);
+    atomic_init(&Ring->tail, full ? (size + capacity) : size);
+    atomic_init(&Ring->threshold, full ? (int64_t)(3u * capacity - 1u) : -1);
+}
+
+static void MCF_mpmc_ring_enqueue(MCF_MpmcRing_t *Ring, uint64_t index, uint8_t order)
+{
+    int64_t threshold = (int64_t)(3u << order) - 1;
+
+    for (;;)
+    {
+        uint64_t tail = atomic_fetch_add(&Ring->tail, 1u);
+        uint64_t cycle = MCF_mpmc_pos_cycle(tail, order);
+        _Atomic uint64_t *slot = &Ring->entries[MCF_mpmc_remap(tail, order)];
+        uint64_t entry = atomic_load_explicit(slot, memory_order_acquire);
+
+        /* Take the entry if it is from an earlier lap and empty, unless a consumer
+         * already passed this position and marked it unsafe. */
+        while ((MCF_mpmc_entry_cycle(entry, order) < cycle) &&
+               (MCF_mpmc_empty(order) == (entry & MCF_mpmc_empty(order))) &&
+               ((0u != (entry & MCF_mpmc_safe(order))) || (atomic_load(&Ring->head) <= tail)))
+        {
+            if (atomic_compare_exchange_weak(slot, &entry,
+                                             MCF_mpmc_entry(cycle, MCF_mpmc_safe(order), index, order)))
+            {
+                if (atomic_load_explicit(&Ring->threshold, memory_order_relaxed) != threshold)
+                {
+                    atomic_store(&Ring->threshold, threshold);
+                }
+                return;
+            }
+        }
+    }
+}
+
+static int MCF_mpmc_ring_dequeue(MCF_MpmcRing_t *Ring, uint64_t *index, uint8_t order)
+{
+    if (0 > atomic_load(&Ring->threshold))
+    {
+        return -1;
+    }
+
+    for (;;)
+    {
+        uint64_t head = atomic_fetch_add(&Ring->head, 1u);
+        uint64_t cycle = MCF_mpmc_pos_cycle(head, order);
+        _Atomic uint64_t *slot = &Ring->entries[MCF_mpmc_remap(head, order)];
+        uint64_t entry = atomic_load_explicit(slot, memory_order_acquire);
+
+        for (;;)
+        {
+            uint64_t entryCycle = MCF_mpmc_entry_cycle(entry, order);
+
+            if (entryCycle == cycle)
+            {
+                /* Consume: set the index bits to "empty", keep the cycle and safe bit. */
+                atomic_fetch_or(slot, MCF_mpmc_empty(order));
+                *index = entry & MCF_mpmc_empty(order);
+                return 0;
+            }
+            if (entryCycle >= cycle)
+            {
+                break;
+            }
+
+            /* The producer of this position is late: an empty entry is moved to our
+             * lap so it cannot publish here, an occupied one is marked unsafe. */
+            uint64_t next = MCF_mpmc_entry(entryCycle, 0, entry & MCF_mpmc_empty(order), order);
+            if (MCF_mpmc_empty(order) == (entry & MCF_mpmc_empty(order)))
+            {
+                next = MCF_mpmc_entry(cycle, entry & MCF_mpmc_safe(order), MCF_mpmc_empty(order), order);
+            }
+            if (atomic_compare_exchange_weak(slot, &entry, next))
+            {
+                break;
+            }
+        }
+
+        uint64_t tail = atomic_load(&Ring->tail);
+        if (tail <= head + 1u)
+        {
+            /* Empty: pull the tail up to the head so producers skip the burnt positions. */
+            uint64_t target = head + 1u;
+
+            while (!atomic_compare_exchange_weak(&Ring->tail, &tail, target))
+            {
+                target = atomic_load(&Ring->head);
+                tail = atomic_load(&Ring->tail);
+                if (tail >= target)
+                {
+                    break;
+                }
+            }
+            atomic_fetch_sub(&Ring->threshold, 1);
+            return -1;
+        }
+        if (0 >= atomic_fetch_sub(&Ring->threshold, 1))
+        {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Takes a free slot, fills it and publishes it to the consumers.
+ */
+static int MCF_mpmc_push(MCF_Mpmc_t *Instance, const MCF_Message_t *Msg)
+{
+    assert(NULL != Instance);
+
+    uint64_t index;
+
+    if (0 != MCF_mpmc_ring_dequeue(&Instance->free, &index, Instance->order))
+    {
+        return -1;
+    }
+    Instance->msgBuf[index] = *Msg;
+    MCF_mpmc_ring_enqueue(&Instance->allocated, index, Instance->order);
+    return 0;
+}
+
+void MCF_mpmc_init(MCF_Mpmc_t *Instance, _Atomic uint64_t *Entries, MCF_Message_t *MsgBuf, uint8_t Order,
+                   void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    assert((NULL != Instance) && (NULL != Entries) && (NULL != MsgBuf) && (0 < Order) && (15 >= Order) &&
+           (NULL != msgParser));
+
+    MCF_mpmc_ring_init(&Instance->allocated, Entries, Order, 0);
+    MCF_mpmc_ring_init(&Instance->free, &Entries[2u << Order], Order, 1);
+    Instance->msgBuf = MsgBuf;
+    Instance->order = Order;
+    Instance->msgParser = msgParser;
+}
+
+int MCF_mpmc_send_u16(MCF_Mpmc_t *Instance, uint16_t msgID, uint16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+
+    return MCF_mpmc_push(Instance, &msg);
+}
+
+int MCF_mpmc_send_i16(MCF_Mpmc_t *Instance, uint16_t msgID, int16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+
+    return MCF_mpmc_push(Instance, &msg);
+}
+
+int MCF_mpmc_send_u32(MCF_Mpmc_t *Instance, uint16_t msgID, uint32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+
+    return MCF_mpmc_push(Instance, &msg);
+}
+
+int MCF_mpmc_send_i32(MCF_Mpmc_t *Instance, uint16_t msgID, int32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+
+    return MCF_mpmc_push(Instance, &msg);
+}
+
+int MCF_mpmc_send_f32(MCF_Mpmc_t *Instance, uint16_t msgID, float value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+
+    return MCF_mpmc_push(Instance, &msg);
+}
+
+uint32_t MCF_mpmc_receive(MCF_Mpmc_t *Instance)
+{
+    return MCF_mpmc_receive_n(Instance, UINT32_MAX);
+}
+
+uint32_t MCF_mpmc_receive_n(MCF_Mpmc_t *Instance, uint32_t maxMessages)
+{
+    assert(NULL != Instance);
+
+    uint32_t received = 0;
+    uint64_t index;
+
+    while ((received < maxMessages) && (0 == MCF_mpmc_ring_dequeue(&Instance->allocated, &index, Instance->order)))
+    {
+        MCF_Message_t msg = Instance->msgBuf[index];
+
+        /* Copy out first so the slot can be reused while the parser runs. */
+        MCF_mpmc_ring_enqueue(&Instance->free, index, Instance->order);
+        Instance->msgParser(&msg);
+        received++;
+    }
+    return received;
+}
+
+uint32_t MCF_mpmc_get_pending(const MCF_Mpmc_t *Instance)
+{
+    assert(NULL != Instance);
+
+    /* Consumers of an empty queue may move head past tail; that reads as empty. */
+    uint64_t head = atomic_load_explicit(&Instance->allocated.head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&Instance->allocated.tail, memory_order_relaxed);
+    uint64_t capacity = 1ull << Instance->order;
+
+    if (tail <= head)
+    {
+        return 0;
+    }
+    return (uint32_t)(((tail - head) > capacity) ? capacity : (tail - head));
+}
@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_MPMC_H_
+#define MULTICORE_FIFO_MCF_MPMC_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/** Number of `Entries` words `MCF_mpmc_init()` needs for a capacity of 2^order messages. */
+#define MCF_MPMC_ENTRIES(order) (4u << (order))
+
+/**
+ * @brief Ring of message slot indices (internal to `MCF_Mpmc_t`).
+ *
+ * Each of its 2 * capacity entries holds a cycle tag, a "safe" bit and a slot
+ * index. Positions are claimed with fetch-and-add on `head`/`tail`, the cycle tag
+ * tells an entry of the current lap from a stale one, so no thread retries a
+ * shared index with CAS. `threshold` lets consumers of an empty ring return
+ * without claiming positions.
+ */
+typedef struct
+{
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic uint64_t head;
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic uint64_t tail;
+    _Alignas(MCF_CACHE_LINE_SIZE) _Atomic int64_t threshold;
+    _Atomic uint64_t *entries;
+} MCF_MpmcRing_t;
+
+/**
+ * @brief Multi-producer, multi-consumer MCF queue (SCQ-style, fetch-and-add claiming).
+ *
+ * Messages live in `msgBuf`; two index rings pass slot numbers around: `allocated`
+ * holds the slots carrying messages in FIFO order, `free` the slots available to
+ * producers. Sends and receives never overrun: a full queue refuses the send.
+ *
+ * Requires lock-free 64-bit atomics (64-bit hosts, AArch64/ARMv7-A with LDREXD);
+ * it is intended for Linux-class cores rather than Cortex-M.
+ *
+ * - `allocated`: Index ring of slots holding messages.
+ * - `free`: Index ring of empty slots.
+ * - `msgBuf`: Message storage of 2^order slots.
+ * - `order`: Base-2 logarithm of the capacity.
+ * - `msgParser`: Callback invoked by `MCF_mpmc_receive()` for every message.
+ */
+typedef struct
+{
+    MCF_MpmcRing_t allocated;
+    MCF_MpmcRing_t free;
+    MCF_Message_t *msgBuf;
+    uint8_t order;
+    void (*msgParser)(MCF_Message_t *msgBuf);
+} MCF_Mpmc_t;
+
+/**
+ * @brief Initializes an MPMC queue holding up to 2^Order messages.
+ *
+ * @param Instance  Pointer to the queue to initialize.
+ * @param Entries   Index ring storage of `MCF_MPMC_ENTRIES(Order)` words.
+ * @param MsgBuf    Message storage of 2^Order messages.
+ * @param Order     Base-2 logarithm of the capacity (1 to 15).
+ * @param msgParser Callback invoked for every received message.
+ */
+void MCF_mpmc_init(MCF_Mpmc_t *Instance, _Atomic uint64_t *Entries, MCF_Message_t *MsgBuf, uint8_t Order,
+                   void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Sends a uint16_t message. Safe to call from any number of threads.
+ *
+ * @param Instance Pointer to the queue.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return 0 on success, -1 when the queue is full (nothing is sent).
+ */
+int MCF_mpmc_send_u16(MCF_Mpmc_t *Instance, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Sends an int16_t message. Safe to call from any number of threads.
+ *
+ * @return 0 on success, -1 when the queue is full (nothing is sent).
+ */
+int MCF_mpmc_send_i16(MCF_Mpmc_t *Instance, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Sends a uint32_t message. Safe to call from any number of threads.
+ *
+ * @return 0 on success, -1 when the queue is full (nothing is sent).
+ */
+int MCF_mpmc_send_u32(MCF_Mpmc_t *Instance, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Sends an int32_t message. Safe to call from any number of threads.
+ *
+ * @return 0 on success, -1 when the queue is full (nothing is sent).
+ */
+int MCF_mpmc_send_i32(MCF_Mpmc_t *Instance, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Sends a float (float32) message. Safe to call from any number of threads.
+ *
+ * @return 0 on success, -1 when the queue is full (nothing is sent).
+ */
+int MCF_mpmc_send_f32(MCF_Mpmc_t *Instance, uint16_t msgID, float value);
+
+/**
+ * @brief Receives messages until the queue is empty and passes each to `msgParser`.
+ *
+ * Safe to call from any number of consumer threads; each message is delivered to
+ * exactly one of them.
+ *
+ * @param Instance Pointer to the queue.
+ * @return Number of messages received.
+ */
+uint32_t MCF_mpmc_receive(MCF_Mpmc_t *Instance);
+
+/**
+ * @brief Receives at most `maxMessages` messages and passes each to `msgParser`.
+ *
+ * Lets a consumer thread return between messages, e.g. to check whether it
+ * should keep running, while the queue stays busy.
+ *
+ * @param Instance    Pointer to the queue.
+ * @param maxMessages Maximum number of messages to receive.
+ * @return Number of messages received.
+ */
+uint32_t MCF_mpmc_receive_n(MCF_Mpmc_t *Instance, uint32_t maxMessages);
+
+/**
+ * @brief Returns an estimate of the number of messages waiting in the queue.
+ *
+ * Producers and consumers move the counters concurrently, so the value is a
+ * snapshot, clamped to the capacity; it is meant for monitoring and scaling
+ * decisions, not for deciding whether a send will succeed.
+ *
+ * @param Instance Pointer to the queue.
+ * @return Number of messages waiting, 0 to 2^order.
+ */
+uint32_t MCF_mpmc_get_pending(const MCF_Mpmc_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_MPMC_H_ */
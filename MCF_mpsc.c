@@ -0,0 +1,265 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_mpsc.h"
+#include "assert.h"
+#include <stddef.h>
+
+/**
+ * @brief Checks that the lane was handed out and has room for one more message.
+ *
+ * Unlike the plain MCF ring, a lane never overruns its consumer: with many
+ * producers a slow consumer must not silently lose one producer's messages.
+ */
+static MCF_t *MCF_mpsc_reserve(MCF_Mpsc_t *Instance, uint8_t lane)
+{
+    assert((NULL != Instance) && (lane < atomic_load_explicit(&Instance->registered, memory_order_relaxed)));
+
+    MCF_t *Lane = &Instance->lanes[lane];
+
+    return (0u < MCF_get_free(Lane)) ? Lane : NULL;
+}
+
+/**
+ * @brief Flags the lane as non-empty after its head was published.
+ *
+ * The fence orders the head store before the bitmap load; the consumer clears the
+ * word with an atomic exchange before reading heads. Either the consumer sees the
+ * new head, or this producer sees its bit cleared and sets it again, so a message
+ * is never left behind an unflagged lane. The OR is skipped while the bit is still
+ * set, so a busy producer does not keep bouncing the bitmap line.
+ */
+static void MCF_mpsc_publish(MCF_Mpsc_t *Instance, uint8_t lane)
+{
+    if (MCF_MPSC_READY_BITMAP == Instance->merge)
+    {
+        atomic_uint *word = &Instance->ready[lane >> 5];
+        unsigned int bit = 1u << (lane & 31u);
+
+        atomic_thread_fence(memory_order_seq_cst);
+        if (0u == (atomic_load_explicit(word, memory_order_relaxed) & bit))
+        {
+            atomic_fetch_or_explicit(word, bit, memory_order_release);
+        }
+    }
+}
+
+/**
+ * @brief Writes one message into the lane and publishes it.
+ *
+ * The release fence keeps the payload stores ahead of the head store, which the
+ * plain `MCF_send_*` do not order for a consumer on another core.
+ */
+static int MCF_mpsc_push(MCF_Mpsc_t *Instance, uint8_t lane, const MCF_Message_t *Msg)
+{
+    MCF_t *Lane = MCF_mpsc_reserve(Instance, lane);
+
+    if (NULL == Lane)
+    {
+        return -1;
+    }
+
+    uint16_t head = *(Lane->head);
+
+    head = (head >= Lane->msgBufSize - 1) ? 0 : (uint16_t)(head + 1u);
+    Lane->msgBuf[head] = *Msg;
+    atomic_thread_fence(memory_order_release);
+    *(Lane->head) = head;
+    MCF_mpsc_publish(Instance, lane);
+    return 0;
+}
+
+/**
+ * @brief Parses up to `maxMessages` of the messages pending in a lane.
+ *
+ * Only messages already published when the head was read are parsed, after an
+ * acquire fence that pairs with the one in `MCF_mpsc_push()`.
+ */
+static uint16_t MCF_mpsc_drain(MCF_t *Lane, uint16_t maxMessages)
+{
+    uint16_t pending = MCF_get_pending(Lane);
+
+    if (pending > maxMessages)
+    {
+        pending = maxMessages;
+    }
+    if (0u == pending)
+    {
+        return 0;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return MCF_receive_n(Lane, pending);
+}
+
+void MCF_mpsc_init(MCF_Mpsc_t *Instance, MCF_t *Lanes, MCF_Indices_t *Indices, MCF_Message_t *MsgBufs,
+                   uint8_t LaneCount, uint16_t LaneSize, void (*msgParser)(MCF_Message_t *msgBuf),
+                   MCF_MpscMerge_t Merge)
+{
+    assert((NULL != Instance) && (NULL != Lanes) && (NULL != Indices) && (NULL != MsgBufs) && (0 < LaneCount) &&
+           (MCF_MPSC_MAX_LANES >= LaneCount) && (1 < LaneSize) && (NULL != msgParser));
+
+    for (uint8_t i = 0; i < LaneCount; i++)
+    {
+        MCF_init_RXTX(&Lanes[i], &Indices[i].head, &Indices[i].tail, &MsgBufs[(size_t)i * LaneSize], LaneSize,
+                      msgParser);
+    }
+
+    Instance->lanes = Lanes;
+    Instance->laneCount = LaneCount;
+    Instance->merge = Merge;
+    Instance->nextLane = 0;
+    for (uint8_t i = 0; i < MCF_MPSC_MAX_LANES; i++)
+    {
+        Instance->quantum[i] = MCF_MPSC_DEFAULT_QUANTUM;
+        Instance->deficit[i] = 0;
+    }
+    atomic_init(&Instance->registered, 0u);
+    for (size_t i = 0; i < sizeof(Instance->ready) / sizeof(Instance->ready[0]); i++)
+    {
+        atomic_init(&Instance->ready[i], 0u);
+    }
+}
+
+int MCF_mpsc_register(MCF_Mpsc_t *Instance)
+{
+    assert(NULL != Instance);
+
+    unsigned int lane = atomic_load_explicit(&Instance->registered, memory_order_relaxed);
+
+    do
+    {
+        if (lane >= Instance->laneCount)
+        {
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&Instance->registered, &lane, lane + 1u, memory_order_acq_rel,
+                                                    memory_order_relaxed));
+
+    return (int)lane;
+}
+
+int MCF_mpsc_send_u16(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, uint16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+
+    return MCF_mpsc_push(Instance, lane, &msg);
+}
+
+int MCF_mpsc_send_i16(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, int16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+
+    return MCF_mpsc_push(Instance, lane, &msg);
+}
+
+int MCF_mpsc_send_u32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, uint32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+
+    return MCF_mpsc_push(Instance, lane, &msg);
+}
+
+int MCF_mpsc_send_i32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, int32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+
+    return MCF_mpsc_push(Instance, lane, &msg);
+}
+
+int MCF_mpsc_send_f32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, float value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+
+    return MCF_mpsc_push(Instance, lane, &msg);
+}
+
+void MCF_mpsc_set_quantum(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t quantum)
+{
+    assert((NULL != Instance) && (lane < Instance->laneCount) && (0 < quantum));
+
+    Instance->quantum[lane] = quantum;
+}
+
+/**
+ * @brief One deficit round-robin round over the registered lanes.
+ *
+ * An empty lane loses its credit, so idle time cannot be saved up for a burst.
+ */
+static void MCF_mpsc_receive_drr(MCF_Mpsc_t *Instance, unsigned int registered)
+{
+    for (unsigned int i = 0, lane = Instance->nextLane; i < registered; i++)
+    {
+        MCF_t *Lane = &Instance->lanes[lane];
+        uint16_t pending = MCF_get_pending(Lane);
+
+        if (0u == pending)
+        {
+            Instance->deficit[lane] = 0;
+        }
+        else
+        {
+            uint32_t credit = (uint32_t)Instance->deficit[lane] + Instance->quantum[lane];
+            uint16_t count = (credit < pending) ? (uint16_t)credit : pending;
+
+            count = MCF_mpsc_drain(Lane, count);
+            credit -= count;
+            Instance->deficit[lane] = (count == pending) ? 0 : (uint16_t)((credit > UINT16_MAX) ? UINT16_MAX : credit);
+        }
+        lane = (lane + 1u < registered) ? lane + 1u : 0u;
+    }
+}
+
+void MCF_mpsc_receive(MCF_Mpsc_t *Instance)
+{
+    assert(NULL != Instance);
+
+    unsigned int registered = atomic_load_explicit(&Instance->registered, memory_order_acquire);
+
+    if (0u == registered)
+    {
+        return;
+    }
+
+    switch (Instance->merge) {
+    case MCF_MPSC_READY_BITMAP:
+        for (unsigned int w = 0; w < ((registered + 31u) >> 5); w++)
+        {
+            unsigned int bits = atomic_exchange_explicit(&Instance->ready[w], 0u, memory_order_seq_cst);
+
+            while (0u != bits)
+            {
+                MCF_mpsc_drain(&Instance->lanes[(w << 5) + (unsigned int)__builtin_ctz(bits)], UINT16_MAX);
+                bits &= bits - 1u;
+            }
+        }
+        break;
+    case MCF_MPSC_DEFICIT_ROUND_ROBIN:
+        if (Instance->nextLane >= registered)
+        {
+            Instance->nextLane = 0;
+        }
+        MCF_mpsc_receive_drr(Instance, registered);
+        Instance->nextLane++;
+        break;
+    case MCF_MPSC_ROUND_ROBIN:
+    default:
+        if (Instance->nextLane >= registered)
+        {
+            Instance->nextLane = 0;
+        }
+        for (unsigned int i = 0, lane = Instance->nextLane; i < registered; i++)
+        {
+            MCF_mpsc_drain(&Instance->lanes[lane], UINT16_MAX);
+            lane = (lane + 1u < registered) ? lane + 1u : 0u;
+        }
+        Instance->nextLane++;
+        break;
+    }
+}
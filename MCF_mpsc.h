@@ -0,0 +1,173 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_MPSC_H_
+#define MULTICORE_FIFO_MCF_MPSC_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/** Maximum number of producer lanes of one channel. */
+#define MCF_MPSC_MAX_LANES 64u
+
+/** Quantum of every lane after `MCF_mpsc_init()`, in messages. */
+#define MCF_MPSC_DEFAULT_QUANTUM 8u
+
+/**
+ * @brief Converts a quantum in bytes to messages, for `MCF_mpsc_set_quantum()`.
+ *
+ * MCF messages have a fixed size, so byte and message shares are proportional.
+ */
+#define MCF_MPSC_QUANTUM_BYTES(bytes)                                                                              \
+    ((((bytes) / sizeof(MCF_Message_t)) > 0u) ? (uint16_t)((bytes) / sizeof(MCF_Message_t)) : (uint16_t)1u)
+
+/**
+ * @brief How the consumer visits the lanes.
+ *
+ * - `MCF_MPSC_ROUND_ROBIN`: Every call polls all registered lanes, starting one lane
+ *   further each time so no lane is always served first.
+ * - `MCF_MPSC_READY_BITMAP`: Producers flag their lane in a shared bitmap when it
+ *   turns non-empty; the consumer only visits flagged lanes. Cheaper for many mostly
+ *   idle producers, at the cost of one atomic OR per idle-to-busy transition.
+ * - `MCF_MPSC_DEFICIT_ROUND_ROBIN`: Every call is one deficit round-robin round: a
+ *   non-empty lane earns its quantum and is served up to its accumulated credit, so
+ *   a chatty producer gets no more than its share while others have messages
+ *   waiting, and quiet producers are served within one round.
+ */
+typedef enum
+{
+    MCF_MPSC_ROUND_ROBIN = 0,
+    MCF_MPSC_READY_BITMAP,
+    MCF_MPSC_DEFICIT_ROUND_ROBIN
+} MCF_MpscMerge_t;
+
+/**
+ * @brief Multi-producer, single-consumer channel built from SPSC lanes.
+ *
+ * Every producer registers once and gets its own MCF ring (lane) with its own head
+ * and tail lines, so sends never contend with other producers: the only shared
+ * write is the optional ready bitmap. The consumer merges the lanes into one
+ * `msgParser` stream. Order is kept per lane, not across lanes; producers that need
+ * to be told apart encode it in `msgID`.
+ *
+ * - `lanes`: Array of `laneCount` MCF handles, one per producer.
+ * - `laneCount`: Number of lanes available for registration.
+ * - `merge`: Lane visiting policy of the consumer.
+ * - `registered`: Number of lanes handed out by `MCF_mpsc_register()`.
+ * - `ready`: Non-empty lanes flagged by producers (`MCF_MPSC_READY_BITMAP`).
+ * - `nextLane`: Lane the next round-robin pass starts from.
+ * - `quantum`: Messages each lane earns per round (`MCF_MPSC_DEFICIT_ROUND_ROBIN`).
+ * - `deficit`: Credit each lane carries over to the next round.
+ */
+typedef struct
+{
+    MCF_t *lanes;
+    uint8_t laneCount;
+    MCF_MpscMerge_t merge;
+    _Alignas(MCF_CACHE_LINE_SIZE) atomic_uint registered;
+    _Alignas(MCF_CACHE_LINE_SIZE) atomic_uint ready[MCF_MPSC_MAX_LANES / 32u];
+    _Alignas(MCF_CACHE_LINE_SIZE) uint8_t nextLane;
+    uint16_t quantum[MCF_MPSC_MAX_LANES];
+    uint16_t deficit[MCF_MPSC_MAX_LANES];
+} MCF_Mpsc_t;
+
+/**
+ * @brief Initializes an MPSC channel.
+ *
+ * Lane `i` uses `Indices[i]` for its head and tail and `MsgBufs[i * LaneSize]` as
+ * its circular buffer.
+ *
+ * @param Instance  Pointer to the channel to initialize.
+ * @param Lanes     Array of `LaneCount` MCF handles.
+ * @param Indices   Array of `LaneCount` head/tail pairs.
+ * @param MsgBufs   Message storage of `LaneCount * LaneSize` messages.
+ * @param LaneCount Number of lanes (1 to `MCF_MPSC_MAX_LANES`).
+ * @param LaneSize  Size of each lane's buffer (number of messages).
+ * @param msgParser Callback invoked by the consumer for every message.
+ * @param Merge     Lane visiting policy.
+ */
+void MCF_mpsc_init(MCF_Mpsc_t *Instance, MCF_t *Lanes, MCF_Indices_t *Indices, MCF_Message_t *MsgBufs,
+                   uint8_t LaneCount, uint16_t LaneSize, void (*msgParser)(MCF_Message_t *msgBuf),
+                   MCF_MpscMerge_t Merge);
+
+/**
+ * @brief Registers a producer and returns its lane.
+ *
+ * Safe to call concurrently from several producers. The lane is owned by the
+ * caller for the lifetime of the channel and must only be used by one thread.
+ *
+ * @param Instance Pointer to the channel.
+ * @return Lane index, or -1 when all lanes are taken.
+ */
+int MCF_mpsc_register(MCF_Mpsc_t *Instance);
+
+/**
+ * @brief Sends a uint16_t message on the producer's lane.
+ *
+ * @param Instance Pointer to the channel.
+ * @param lane     Lane returned by `MCF_mpsc_register()`.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return 0 on success, -1 when the lane is full (nothing is sent).
+ */
+int MCF_mpsc_send_u16(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Sends an int16_t message on the producer's lane.
+ *
+ * @return 0 on success, -1 when the lane is full (nothing is sent).
+ */
+int MCF_mpsc_send_i16(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Sends a uint32_t message on the producer's lane.
+ *
+ * @return 0 on success, -1 when the lane is full (nothing is sent).
+ */
+int MCF_mpsc_send_u32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Sends an int32_t message on the producer's lane.
+ *
+ * @return 0 on success, -1 when the lane is full (nothing is sent).
+ */
+int MCF_mpsc_send_i32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Sends a float (float32) message on the producer's lane.
+ *
+ * @return 0 on success, -1 when the lane is full (nothing is sent).
+ */
+int MCF_mpsc_send_f32(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t msgID, float value);
+
+/**
+ * @brief Sets the deficit round-robin quantum of a lane.
+ *
+ * Consumer side; lanes served with a larger quantum get a proportionally larger
+ * share of the consumer. Use `MCF_MPSC_QUANTUM_BYTES()` for a quantum in bytes.
+ *
+ * @param Instance Pointer to the channel.
+ * @param lane     Lane to configure (0 to `laneCount - 1`).
+ * @param quantum  Messages the lane earns per round (at least 1).
+ */
+void MCF_mpsc_set_quantum(MCF_Mpsc_t *Instance, uint8_t lane, uint16_t quantum);
+
+/**
+ * @brief Drains the lanes selected by the merge policy into `msgParser`.
+ *
+ * Must only be called by the single consumer. Should be invoked regularly in the
+ * consumer's main loop, like `MCF_receive()`.
+ *
+ * @param Instance Pointer to the channel.
+ */
+void MCF_mpsc_receive(MCF_Mpsc_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_MPSC_H_ */
@@ -0,0 +1,257 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#define _GNU_SOURCE
+#include "MCF_percpu.h"
+#include "assert.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define MCF_PERCPU_HAVE_RSEQ 1
+#endif
+#endif
+
+#ifndef MCF_PERCPU_HAVE_RSEQ
+#define MCF_PERCPU_HAVE_RSEQ 0
+#endif
+
+/** Failed lock attempts before a sender yields the CPU to a preempted lock holder. */
+#define MCF_PERCPU_LOCK_SPINS 64u
+
+#if MCF_PERCPU_HAVE_RSEQ
+_Static_assert(8 == sizeof(MCF_Message_t), "the rseq commit path stores a message as one 64-bit word");
+
+/**
+ * @brief Advances the head of the calling CPU's ring inside a restartable sequence.
+ *
+ * The sequence checks that the thread still runs on `cpu`, computes the next head
+ * the way `MCF_send_*` does, refuses if it would reach the tail, writes the message
+ * and commits with the head store. Preemption, migration or a signal anywhere
+ * before the commit makes the kernel jump to the abort handler, which restarts.
+ *
+ * @return 0 on success, -1 when the ring is full, 1 when the sequence was aborted.
+ */
+static int MCF_percpu_rseq_push(struct rseq *Rseq, uint32_t cpu, MCF_t *Ring, uint64_t msg)
+{
+    uint32_t last = (uint32_t)Ring->msgBufSize - 1u;
+
+    __asm__ goto(".pushsection __rseq_cs, \"aw\"\n\t"
+                 ".balign 32\n\t"
+                 "3:\n\t"
+                 ".long 0x0, 0x0\n\t"
+                 ".quad 1f, (2f - 1f), 4f\n\t"
+                 ".popsection\n\t"
+                 "leaq 3b(%%rip), %%rax\n\t"
+                 "movq %%rax, %[rseqCs]\n\t"
+                 "1:\n\t"
+                 "cmpl %[cpu], %[cpuId]\n\t"
+                 "jnz %l[aborted]\n\t"
+                 /* next = (head >= last) ? 0 : head + 1 */
+                 "movzwl (%[head]), %%eax\n\t"
+                 "xorl %%ecx, %%ecx\n\t"
+                 "cmpl %[last], %%eax\n\t"
+                 "jae 5f\n\t"
+                 "leal 1(%%rax), %%ecx\n\t"
+                 "5:\n\t"
+                 /* MCF_receive() lets the tail reach the size before wrapping it to 0. */
+                 "movzwl (%[tail]), %%edx\n\t"
+                 "cmpl %[last], %%edx\n\t"
+                 "jbe 6f\n\t"
+                 "xorl %%edx, %%edx\n\t"
+                 "6:\n\t"
+                 "cmpl %%edx, %%ecx\n\t"
+                 "je %l[full]\n\t"
+                 "movq %[msg], (%[buf], %%rcx, 8)\n\t"
+                 "movw %%cx, (%[head])\n\t"
+                 "2:\n\t"
+                 ".pushsection __rseq_failure, \"ax\"\n\t"
+                 /* The abort handler must be preceded by the signature glibc registered. */
+                 ".byte 0x0f, 0xb9, 0x3d\n\t"
+                 ".long %c[sig]\n\t"
+                 "4:\n\t"
+                 "jmp %l[aborted]\n\t"
+                 ".popsection\n\t"
+                 : [rseqCs] "+m"(Rseq->rseq_cs)
+                 : [cpuId] "m"(Rseq->cpu_id), [cpu] "r"(cpu), [head] "r"(Ring->head), [tail] "r"(Ring->tail),
+                   [buf] "r"(Ring->msgBuf), [last] "r"(last), [msg] "r"(msg), [sig] "i"(RSEQ_SIG)
+                 : "rax", "rcx", "rdx", "memory", "cc"
+                 : aborted, full);
+    return 0;
+aborted:
+    return 1;
+full:
+    return -1;
+}
+#endif
+
+/**
+ * @brief Sends under the ring's spinlock when restartable sequences are unavailable.
+ */
+static int MCF_percpu_locked_push(MCF_Percpu_t *Instance, const MCF_Message_t *Msg)
+{
+    uint32_t cpu = 0;
+
+#if defined(__linux__)
+    int current = sched_getcpu();
+    if (0 <= current)
+    {
+        cpu = (uint32_t)current;
+    }
+#endif
+
+    MCF_t *Ring = &Instance->rings[cpu % Instance->cpuCount];
+    atomic_flag *lock = &Instance->indices[cpu % Instance->cpuCount].lock;
+    int result = -1;
+
+    for (uint32_t spins = 0; atomic_flag_test_and_set_explicit(lock, memory_order_acquire); spins++)
+    {
+#if defined(__linux__)
+        /* The holder may have been preempted on this CPU; spinning on would burn the time slice. */
+        if (spins >= MCF_PERCPU_LOCK_SPINS)
+        {
+            sched_yield();
+            spins = 0;
+        }
+#endif
+    }
+
+    if (0u < MCF_get_free(Ring))
+    {
+        uint16_t head = *(Ring->head);
+
+        head = (head >= Ring->msgBufSize - 1) ? 0 : (uint16_t)(head + 1u);
+        Ring->msgBuf[head] = *Msg;
+        atomic_thread_fence(memory_order_release);
+        *(Ring->head) = head;
+        result = 0;
+    }
+
+    atomic_flag_clear_explicit(lock, memory_order_release);
+    return result;
+}
+
+static int MCF_percpu_push(MCF_Percpu_t *Instance, const MCF_Message_t *Msg)
+{
+    assert(NULL != Instance);
+
+#if MCF_PERCPU_HAVE_RSEQ
+    if (Instance->useRseq)
+    {
+        struct rseq *Rseq = (struct rseq *)((uintptr_t)__builtin_thread_pointer() + (uintptr_t)__rseq_offset);
+        uint64_t msg;
+
+        memcpy(&msg, Msg, sizeof(msg));
+        for (;;)
+        {
+            uint32_t cpu = __atomic_load_n(&Rseq->cpu_id, __ATOMIC_RELAXED);
+
+            /* Init covers every possible CPU id; never index past the rings regardless. */
+            if (cpu >= Instance->cpuCount)
+            {
+                break;
+            }
+
+            int result = MCF_percpu_rseq_push(Rseq, cpu, &Instance->rings[cpu], msg);
+            if (1 != result)
+            {
+                return result;
+            }
+        }
+    }
+#endif
+
+    return MCF_percpu_locked_push(Instance, Msg);
+}
+
+void MCF_percpu_init(MCF_Percpu_t *Instance, MCF_t *Rings, MCF_PercpuIndices_t *Indices, MCF_Message_t *MsgBufs,
+                     uint16_t CpuCount, uint16_t RingSize, void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    assert((NULL != Instance) && (NULL != Rings) && (NULL != Indices) && (NULL != MsgBufs) && (0 < CpuCount) &&
+           (1 < RingSize) && (NULL != msgParser));
+
+    for (uint16_t i = 0; i < CpuCount; i++)
+    {
+        MCF_init_RXTX(&Rings[i], &Indices[i].head, &Indices[i].tail, &MsgBufs[(size_t)i * RingSize], RingSize,
+                      msgParser);
+        atomic_flag_clear(&Indices[i].lock);
+    }
+
+    Instance->rings = Rings;
+    Instance->indices = Indices;
+    Instance->cpuCount = CpuCount;
+#if MCF_PERCPU_HAVE_RSEQ
+    /* The rseq path writes its ring unlocked: every CPU id must have a ring of its own. */
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    Instance->useRseq = (0u < __rseq_size) && (0 < configured) && (configured <= (long)CpuCount);
+#else
+    Instance->useRseq = 0;
+#endif
+}
+
+int MCF_percpu_send_u16(MCF_Percpu_t *Instance, uint16_t msgID, uint16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u16 = value};
+
+    return MCF_percpu_push(Instance, &msg);
+}
+
+int MCF_percpu_send_i16(MCF_Percpu_t *Instance, uint16_t msgID, int16_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i16 = value};
+
+    return MCF_percpu_push(Instance, &msg);
+}
+
+int MCF_percpu_send_u32(MCF_Percpu_t *Instance, uint16_t msgID, uint32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .u32 = value};
+
+    return MCF_percpu_push(Instance, &msg);
+}
+
+int MCF_percpu_send_i32(MCF_Percpu_t *Instance, uint16_t msgID, int32_t value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .i32 = value};
+
+    return MCF_percpu_push(Instance, &msg);
+}
+
+int MCF_percpu_send_f32(MCF_Percpu_t *Instance, uint16_t msgID, float value)
+{
+    MCF_Message_t msg = {.msgID = msgID, .f32 = value};
+
+    return MCF_percpu_push(Instance, &msg);
+}
+
+void MCF_percpu_receive(MCF_Percpu_t *Instance)
+{
+    assert(NULL != Instance);
+
+    for (uint16_t i = 0; i < Instance->cpuCount; i++)
+    {
+        MCF_t *Ring = &Instance->rings[i];
+        uint16_t pending = MCF_get_pending(Ring);
+
+        /* Pairs with the locked path's release fence; the x86-only rseq path stores in order. */
+        if (0u != pending)
+        {
+            atomic_thread_fence(memory_order_acquire);
+            MCF_receive_n(Ring, pending);
+        }
+    }
+}
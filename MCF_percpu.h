@@ -0,0 +1,118 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_PERCPU_H_
+#define MULTICORE_FIFO_MCF_PERCPU_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief Indices of one per-CPU ring.
+ *
+ * The head line is written by whichever thread runs on that CPU, so it also holds
+ * the lock used when restartable sequences are not available.
+ */
+typedef struct
+{
+    _Alignas(MCF_CACHE_LINE_SIZE) uint16_t head;
+    atomic_flag lock;
+    _Alignas(MCF_CACHE_LINE_SIZE) uint16_t tail;
+} MCF_PercpuIndices_t;
+
+/**
+ * @brief Multi-producer, single-consumer channel sharded by CPU (Linux).
+ *
+ * A producer writes into the MCF ring of the CPU it is running on, so any number of
+ * short-lived threads can send without registering. On x86-64 Linux with glibc
+ * 2.35 or newer the write is a restartable sequence: the kernel aborts it when the
+ * thread is preempted or migrated before the head store commits it, so the fast
+ * path has no atomic read-modify-write. Elsewhere, or when glibc did not register
+ * rseq, sends take a per-ring spinlock instead. Restartable sequences are only used
+ * when `cpuCount` covers every configured CPU, since the unlocked rseq writer of a
+ * ring must be its only producer. The consumer drains every ring.
+ *
+ * - `rings`: One MCF handle per CPU.
+ * - `indices`: Head/tail/lock of every ring.
+ * - `cpuCount`: Number of rings; must cover every CPU id a producer can run on.
+ * - `useRseq`: Non-zero when sends use restartable sequences.
+ */
+typedef struct
+{
+    MCF_t *rings;
+    MCF_PercpuIndices_t *indices;
+    uint16_t cpuCount;
+    uint8_t useRseq;
+} MCF_Percpu_t;
+
+/**
+ * @brief Initializes a per-CPU channel.
+ *
+ * @param Instance  Pointer to the channel to initialize.
+ * @param Rings     Array of `CpuCount` MCF handles.
+ * @param Indices   Array of `CpuCount` ring indices.
+ * @param MsgBufs   Message storage of `CpuCount * RingSize` messages.
+ * @param CpuCount  Number of possible CPUs (e.g. `sysconf(_SC_NPROCESSORS_CONF)`).
+ * @param RingSize  Size of each ring (number of messages).
+ * @param msgParser Callback invoked by the consumer for every message.
+ */
+void MCF_percpu_init(MCF_Percpu_t *Instance, MCF_t *Rings, MCF_PercpuIndices_t *Indices, MCF_Message_t *MsgBufs,
+                     uint16_t CpuCount, uint16_t RingSize, void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Sends a uint16_t message on the ring of the calling thread's CPU.
+ *
+ * @param Instance Pointer to the channel.
+ * @param msgID    Identifier of the message to send.
+ * @param value    16-bit unsigned value to include in the message payload.
+ * @return 0 on success, -1 when that ring is full (nothing is sent).
+ */
+int MCF_percpu_send_u16(MCF_Percpu_t *Instance, uint16_t msgID, uint16_t value);
+
+/**
+ * @brief Sends an int16_t message on the ring of the calling thread's CPU.
+ *
+ * @return 0 on success, -1 when that ring is full (nothing is sent).
+ */
+int MCF_percpu_send_i16(MCF_Percpu_t *Instance, uint16_t msgID, int16_t value);
+
+/**
+ * @brief Sends a uint32_t message on the ring of the calling thread's CPU.
+ *
+ * @return 0 on success, -1 when that ring is full (nothing is sent).
+ */
+int MCF_percpu_send_u32(MCF_Percpu_t *Instance, uint16_t msgID, uint32_t value);
+
+/**
+ * @brief Sends an int32_t message on the ring of the calling thread's CPU.
+ *
+ * @return 0 on success, -1 when that ring is full (nothing is sent).
+ */
+int MCF_percpu_send_i32(MCF_Percpu_t *Instance, uint16_t msgID, int32_t value);
+
+/**
+ * @brief Sends a float (float32) message on the ring of the calling thread's CPU.
+ *
+ * @return 0 on success, -1 when that ring is full (nothing is sent).
+ */
+int MCF_percpu_send_f32(MCF_Percpu_t *Instance, uint16_t msgID, float value);
+
+/**
+ * @brief Drains all per-CPU rings into `msgParser`.
+ *
+ * Must only be called by the single consumer. Messages of one producer thread keep
+ * their order only while it stays on one CPU.
+ *
+ * @param Instance Pointer to the channel.
+ */
+void MCF_percpu_receive(MCF_Percpu_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_PERCPU_H_ */
@@ -0,0 +1,119 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_TRACE_H_
+#define MULTICORE_FIFO_MCF_TRACE_H_
+
+/**
+ * @file MCF_trace.h
+ * @brief Optional USDT (static tracepoint) probes and chaos hooks for the MCF queue.
+ *
+ * Build with `-DMCF_ENABLE_USDT` to place probes of provider `mcf` in the send and
+ * receive paths. The probes are taken from `<sys/sdt.h>` (systemtap-sdt-dev), so an
+ * unmodified binary can be profiled with bpftrace or perf, e.g.:
+ *
+ *     bpftrace -e 'usdt:./app:mcf:overflow { @lost[arg0] = count(); }'
+ *
+ * Available probes:
+ * - `send(ring, msgID, occupancy)`      message written by `MCF_send_*`, occupancy after publish.
+ * - `overflow(ring, msgID, lost)`       send wrapped onto the consumer and dropped `lost` unread messages.
+ * - `receive(ring, msgID, occupancy)`   message handed to `msgParser`, occupancy still pending.
+ * - `receive_batch(ring, count)`        `MCF_receive` drained `count` messages in one call.
+ *
+ * `ring` is the address of the message buffer, so it identifies the shared ring
+ * rather than the per-core `MCF_t` handle.
+ *
+ * When the option is off, or `<sys/sdt.h>` is not available for the target, every
+ * probe expands to nothing and no code or data is added to the library.
+ */
+
+#if defined(MCF_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MCF_TRACE_ENABLED 1
+#endif
+#endif
+
+#ifdef MCF_TRACE_ENABLED
+
+/** Number of messages between tail and head of a ring of `size` slots. */
+#define MCF_TRACE_OCCUPANCY(head, tail, size)                                                                         \
+    ((uint16_t)(((head) >= (tail)) ? ((head) - (tail)) : ((size) - (tail) + (head))))
+
+/** Called with the new head index right before it is published. */
+#define MCF_TRACE_SEND(Instance, newHead, msgID)                                                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        uint16_t mcfTraceTail = *((Instance)->tail);                                                                   \
+        if ((newHead) == mcfTraceTail)                                                                                 \
+        {                                                                                                              \
+            DTRACE_PROBE3(mcf, overflow, (Instance)->msgBuf, (msgID), (Instance)->msgBufSize - 1);                     \
+        }                                                                                                              \
+        DTRACE_PROBE3(mcf, send, (Instance)->msgBuf, (msgID),                                                          \
+                      MCF_TRACE_OCCUPANCY((newHead), mcfTraceTail, (Instance)->msgBufSize));                           \
+    } while (0)
+
+/** Called with the tail already advanced, right before the parser runs. */
+#define MCF_TRACE_RECEIVE(Instance, msgID)                                                                            \
+    DTRACE_PROBE3(mcf, receive, (Instance)->msgBuf, (msgID),                                                           \
+                  MCF_TRACE_OCCUPANCY(*((Instance)->head), *((Instance)->tail), (Instance)->msgBufSize))
+
+#define MCF_TRACE_RECEIVE_BATCH(Instance, count)                                                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (0 < (count))                                                                                               \
+        {                                                                                                              \
+            DTRACE_PROBE2(mcf, receive_batch, (Instance)->msgBuf, (count));                                            \
+        }                                                                                                              \
+    } while (0)
+
+#else
+
+#define MCF_TRACE_SEND(Instance, newHead, msgID) ((void)0)
+#define MCF_TRACE_RECEIVE(Instance, msgID) ((void)0)
+#define MCF_TRACE_RECEIVE_BATCH(Instance, count) ((void)(count))
+
+#endif /* MCF_TRACE_ENABLED */
+
+/**
+ * @brief Chaos injection points of the index protocol.
+ *
+ * Build with `-DMCF_ENABLE_CHAOS` to call `MCF_chaos_hook()` at each of these
+ * sites. The stress harness implements the hook to inject random yields, sleeps
+ * and CPU migrations into the windows where a protocol race would surface:
+ * - `MCF_CHAOS_SEND_PUBLISH`: payload written, head not yet published.
+ * - `MCF_CHAOS_RECEIVE_ADVANCE`: new message seen, tail not yet advanced.
+ * - `MCF_CHAOS_RECEIVE_WRAP`: tail incremented, not yet wrapped to 0.
+ * - `MCF_CHAOS_RECEIVE_PARSE`: tail published, slot not yet handed to the parser.
+ *
+ * The hook is an opaque call, so it also acts as a compiler barrier at the site.
+ * Production builds never define the option and the points compile to nothing.
+ */
+typedef enum
+{
+    MCF_CHAOS_SEND_PUBLISH = 0,
+    MCF_CHAOS_RECEIVE_ADVANCE,
+    MCF_CHAOS_RECEIVE_WRAP,
+    MCF_CHAOS_RECEIVE_PARSE,
+    MCF_CHAOS_SITE_COUNT
+} MCF_chaos_site_t;
+
+/**
+ * @brief Chaos hook, provided by the application or test harness in chaos builds.
+ */
+void MCF_chaos_hook(MCF_chaos_site_t site);
+
+#ifdef MCF_ENABLE_CHAOS
+#define MCF_CHAOS_POINT(site) MCF_chaos_hook(site)
+#else
+#define MCF_CHAOS_POINT(site) ((void)0)
+#endif
+
+#endif /* MULTICORE_FIFO_MCF_TRACE_H_ */
@@ -0,0 +1,325 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * io_uring is driven through its system calls and the UAPI header directly, so
+ * the sink does not depend on liburing. The submission and completion rings are
+ * shared with the kernel: the sink owns the SQ tail and the CQ head, the kernel
+ * the SQ head and the CQ tail.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_uring.h"
+#include "assert.h"
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static int MCF_uring_enter(MCF_Uring_t *Instance, uint32_t minComplete)
+{
+    uint32_t toSubmit = atomic_load_explicit(Instance->sqTail, memory_order_relaxed) -
+                        atomic_load_explicit(Instance->sqHead, memory_order_acquire);
+    long result;
+
+    if ((0u == toSubmit) && (0u == minComplete))
+    {
+        return 0;
+    }
+    do
+    {
+        result = syscall(__NR_io_uring_enter, Instance->uringFd, toSubmit, minComplete,
+                         (0u != minComplete) ? IORING_ENTER_GETEVENTS : 0u, NULL, 0);
+    } while ((0 > result) && (EINTR == errno));
+
+    /* EAGAIN/EBUSY leave the entries in the SQ ring; the next call submits them. */
+    return ((0 > result) && (EAGAIN != errno) && (EBUSY != errno)) ? -1 : 0;
+}
+
+/**
+ * @brief Puts a write of the span into the submission ring.
+ */
+static void MCF_uring_queue(MCF_Uring_t *Instance, uint16_t slot)
+{
+    MCF_UringSpan_t *span = &Instance->spans[slot];
+    uint32_t tail = atomic_load_explicit(Instance->sqTail, memory_order_relaxed);
+    uint32_t index = tail & Instance->sqMask;
+    struct io_uring_sqe *sqe = &((struct io_uring_sqe *)Instance->sqes)[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = Instance->registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = Instance->fd;
+    sqe->addr = (uint64_t)(uintptr_t)span->data;
+    sqe->len = span->bytes;
+    sqe->off = Instance->stream ? (uint64_t)-1 : (uint64_t)span->fileOffset;
+    sqe->buf_index = 0;
+    sqe->user_data = slot;
+    Instance->sqArray[index] = index;
+
+    atomic_store_explicit(Instance->sqTail, tail + 1u, memory_order_release);
+    span->busy = 1;
+    Instance->submitted++;
+}
+
+/**
+ * @brief Applies the completions that arrived; returns -1 if a write failed.
+ */
+static int MCF_uring_reap(MCF_Uring_t *Instance)
+{
+    uint32_t head = atomic_load_explicit(Instance->cqHead, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(Instance->cqTail, memory_order_acquire);
+    int result = 0;
+
+    for (; head != tail; head++)
+    {
+        const struct io_uring_cqe *cqe = &((const struct io_uring_cqe *)Instance->cqes)[head & Instance->cqMask];
+        MCF_UringSpan_t *span = &Instance->spans[cqe->user_data];
+
+        span->busy = 0;
+        Instance->completed++;
+        if (0 > cqe->res)
+        {
+            if ((-EAGAIN != cqe->res) && (-EINTR != cqe->res))
+            {
+                Instance->error = -cqe->res;
+                result = -1;
+            }
+        }
+        else if ((uint32_t)cqe->res < span->bytes)
+        {
+            span->data += cqe->res;
+            span->bytes -= (uint32_t)cqe->res;
+            span->fileOffset += cqe->res;
+            Instance->shortWrites++;
+        }
+        else
+        {
+            span->bytes = 0;
+        }
+    }
+    atomic_store_explicit(Instance->cqHead, head, memory_order_release);
+    return result;
+}
+
+/**
+ * @brief Releases the written spans at the front; returns the messages released.
+ */
+static uint16_t MCF_uring_release(MCF_Uring_t *Instance)
+{
+    uint16_t released = 0;
+
+    while ((0u < Instance->spanCount) && (0u == Instance->spans[Instance->spanHead].bytes))
+    {
+        released = (uint16_t)(released + Instance->spans[Instance->spanHead].messages);
+        Instance->spanHead = (uint16_t)((Instance->spanHead + 1u) & (MCF_URING_DEPTH - 1u));
+        Instance->spanCount--;
+    }
+    if (0u < released)
+    {
+        MCF_release(Instance->ring, released);
+        Instance->inflight = (uint16_t)(Instance->inflight - released);
+        Instance->messages += released;
+    }
+    return released;
+}
+
+/**
+ * @brief Turns newly pending messages into spans and queues every span that needs a write.
+ */
+static void MCF_uring_fill(MCF_Uring_t *Instance)
+{
+    while (MCF_URING_DEPTH > Instance->spanCount)
+    {
+        MCF_Message_t *data;
+        uint16_t count = MCF_peek(Instance->ring, Instance->inflight, &data);
+
+        if (0u == count)
+        {
+            break;
+        }
+
+        uint16_t slot = (uint16_t)((Instance->spanHead + Instance->spanCount) & (MCF_URING_DEPTH - 1u));
+        uint32_t bytes = (uint32_t)count * sizeof(MCF_Message_t);
+
+        Instance->spans[slot] = (MCF_UringSpan_t){
+            .data = (const uint8_t *)data, .bytes = bytes, .messages = count, .fileOffset = Instance->fileOffset};
+        Instance->fileOffset += bytes;
+        Instance->inflight = (uint16_t)(Instance->inflight + count);
+        Instance->spanCount++;
+    }
+
+    for (uint16_t i = 0; i < Instance->spanCount; i++)
+    {
+        uint16_t slot = (uint16_t)((Instance->spanHead + i) & (MCF_URING_DEPTH - 1u));
+        MCF_UringSpan_t *span = &Instance->spans[slot];
+
+        if (0u == span->bytes)
+        {
+            continue;
+        }
+        if (!span->busy)
+        {
+            MCF_uring_queue(Instance, slot);
+        }
+        if (Instance->stream)
+        {
+            /* One write at a time, oldest first, keeps a stream in order. */
+            break;
+        }
+    }
+}
+
+int MCF_uring_init(MCF_Uring_t *Instance, MCF_t *Ring, int Fd, int64_t FileOffset)
+{
+    assert((NULL != Instance) && (NULL != Ring) && (0 <= Fd));
+    assert(0u == (MCF_URING_DEPTH & (MCF_URING_DEPTH - 1u)));
+
+    struct io_uring_params params;
+
+    memset(Instance, 0, sizeof(*Instance));
+    memset(&params, 0, sizeof(params));
+    Instance->ring = Ring;
+    Instance->fd = Fd;
+    Instance->stream = (0 > FileOffset);
+    Instance->fileOffset = Instance->stream ? 0 : FileOffset;
+
+    Instance->uringFd = (int)syscall(__NR_io_uring_setup, MCF_URING_DEPTH, &params);
+    if (0 > Instance->uringFd)
+    {
+        return -errno;
+    }
+
+    Instance->sqMask = params.sq_entries - 1u;
+    Instance->cqMask = params.cq_entries - 1u;
+    Instance->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    Instance->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (Instance->cqRingSize > Instance->sqRingSize)
+        {
+            Instance->sqRingSize = Instance->cqRingSize;
+        }
+        Instance->cqRingSize = Instance->sqRingSize;
+    }
+
+    Instance->sqRing = mmap(NULL, Instance->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            Instance->uringFd, IORING_OFF_SQ_RING);
+    Instance->cqRing = (params.features & IORING_FEAT_SINGLE_MMAP)
+                           ? Instance->sqRing
+                           : mmap(NULL, Instance->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  Instance->uringFd, IORING_OFF_CQ_RING);
+    Instance->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, Instance->uringFd, IORING_OFF_SQES);
+    if ((MAP_FAILED == Instance->sqRing) || (MAP_FAILED == Instance->cqRing) || (MAP_FAILED == Instance->sqes))
+    {
+        int error = errno;
+
+        MCF_uring_deinit(Instance);
+        return -error;
+    }
+
+    uint8_t *sq = Instance->sqRing;
+    uint8_t *cq = Instance->cqRing;
+    Instance->sqHead = (_Atomic uint32_t *)(sq + params.sq_off.head);
+    Instance->sqTail = (_Atomic uint32_t *)(sq + params.sq_off.tail);
+    Instance->sqArray = (uint32_t *)(sq + params.sq_off.array);
+    Instance->cqHead = (_Atomic uint32_t *)(cq + params.cq_off.head);
+    Instance->cqTail = (_Atomic uint32_t *)(cq + params.cq_off.tail);
+    Instance->cqes = cq + params.cq_off.cqes;
+
+    /* Registration pins the ring buffer once; it fails under a low RLIMIT_MEMLOCK. */
+    struct iovec buffer = {Ring->msgBuf, (size_t)Ring->msgBufSize * sizeof(MCF_Message_t)};
+    Instance->registered =
+        (0 == syscall(__NR_io_uring_register, Instance->uringFd, IORING_REGISTER_BUFFERS, &buffer, 1));
+    return 0;
+}
+
+int MCF_uring_poll(MCF_Uring_t *Instance)
+{
+    assert(NULL != Instance);
+
+    int result = MCF_uring_reap(Instance);
+    uint16_t released = MCF_uring_release(Instance);
+
+    MCF_uring_fill(Instance);
+    if (0 != MCF_uring_enter(Instance, 0))
+    {
+        Instance->error = errno;
+        result = -1;
+    }
+
+    /* Writes that hit the page cache often complete inside the submit call. */
+    result |= MCF_uring_reap(Instance);
+    released = (uint16_t)(released + MCF_uring_release(Instance));
+    return (0 > result) ? -1 : released;
+}
+
+int MCF_uring_flush(MCF_Uring_t *Instance)
+{
+    assert(NULL != Instance);
+
+    for (;;)
+    {
+        if (0 > MCF_uring_poll(Instance))
+        {
+            return -1;
+        }
+        if ((0u == Instance->spanCount) && (0u == MCF_get_pending(Instance->ring)))
+        {
+            return 0;
+        }
+        if ((Instance->submitted != Instance->completed) && (0 != MCF_uring_enter(Instance, 1)))
+        {
+            Instance->error = errno;
+            return -1;
+        }
+    }
+}
+
+void MCF_uring_deinit(MCF_Uring_t *Instance)
+{
+    assert(NULL != Instance);
+
+    /* The kernel may still read ring slots until every write completed. */
+    while ((NULL != Instance->cqes) && (Instance->submitted != Instance->completed))
+    {
+        if (0 != MCF_uring_enter(Instance, 1))
+        {
+            break;
+        }
+        (void)MCF_uring_reap(Instance);
+    }
+    if (NULL != Instance->cqes)
+    {
+        (void)MCF_uring_release(Instance);
+    }
+
+    if ((NULL != Instance->sqes) && (MAP_FAILED != Instance->sqes))
+    {
+        munmap(Instance->sqes, (size_t)(Instance->sqMask + 1u) * sizeof(struct io_uring_sqe));
+    }
+    if ((NULL != Instance->cqRing) && (MAP_FAILED != Instance->cqRing) && (Instance->cqRing != Instance->sqRing))
+    {
+        munmap(Instance->cqRing, Instance->cqRingSize);
+    }
+    if ((NULL != Instance->sqRing) && (MAP_FAILED != Instance->sqRing))
+    {
+        munmap(Instance->sqRing, Instance->sqRingSize);
+    }
+    if (0 <= Instance->uringFd)
+    {
+        close(Instance->uringFd);
+    }
+    memset(Instance, 0, sizeof(*Instance));
+    Instance->uringFd = -1;
+}
@@ -0,0 +1,146 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_URING_H_
+#define MULTICORE_FIFO_MCF_URING_H_
+
+#include "MCF.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Writes in flight at most; a power of two. */
+#ifndef MCF_URING_DEPTH
+#define MCF_URING_DEPTH 16u
+#endif
+
+/** `FileOffset` of `MCF_uring_init()` for sockets, pipes and append-only files. */
+#define MCF_URING_STREAM (-1)
+
+/**
+ * @brief A write in flight: one contiguous span of ring slots.
+ *
+ * - `data`: Next byte to write (moves forward on a short write).
+ * - `bytes`: Bytes still to write.
+ * - `messages`: Messages in the span, released once all of it is written.
+ * - `busy`: Non-zero while a write of the span is in flight.
+ * - `fileOffset`: File offset of `data` (positioned mode only).
+ */
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t bytes;
+    uint16_t messages;
+    uint8_t busy;
+    int64_t fileOffset;
+} MCF_UringSpan_t;
+
+/**
+ * @brief Drains a ring into a file or socket through io_uring.
+ *
+ * The sink is the consumer of `ring`. Pending messages are handed to the kernel
+ * as write requests pointing straight at the ring slots (`MCF_peek()`), so
+ * nothing is copied and the consumer never waits for the device. A span's slots
+ * are released with `MCF_release()` only when its completion arrived, in ring
+ * order, so the producer cannot overwrite data the kernel is still reading.
+ *
+ * In positioned mode (`FileOffset >= 0`) every span is written at its own file
+ * offset and up to `MCF_URING_DEPTH` writes are in flight. In stream mode
+ * (`MCF_URING_STREAM`) writes to the same socket or pipe could complete out of
+ * order, so only one is in flight at a time. The ring buffer is registered with
+ * the kernel when the memory lock limit allows (`registered`), which saves the
+ * per-write page pinning; otherwise plain writes are used.
+ *
+ * - `ring`: Receiving MCF handle to drain.
+ * - `fd`: Destination file or socket.
+ * - `uringFd`: The io_uring instance.
+ * - `registered`: Non-zero if `ring`'s buffer is a registered (fixed) buffer.
+ * - `stream`: Non-zero in stream mode.
+ * - `fileOffset`: Positioned mode: file offset of the next new span.
+ * - `spans`: Writes in flight, oldest first from `spanHead`.
+ * - `spanHead`, `spanCount`: Ring of in-flight spans.
+ * - `inflight`: Messages peeked but not yet released.
+ * - `sqRing`, `sqRingSize`, `cqRing`, `cqRingSize`, `sqes`: Mappings shared with the kernel.
+ * - `sqHead` .. `cqes`: Pointers into those mappings.
+ * - `submitted`, `completed`: Writes submitted and completed.
+ * - `messages`: Messages written and released.
+ * - `shortWrites`: Writes the kernel accepted only in part (remainder resubmitted).
+ * - `error`: errno of the last failed write, 0 if none.
+ */
+typedef struct
+{
+    MCF_t *ring;
+    int fd;
+    int uringFd;
+    uint8_t registered;
+    uint8_t stream;
+    int64_t fileOffset;
+    MCF_UringSpan_t spans[MCF_URING_DEPTH];
+    uint16_t spanHead;
+    uint16_t spanCount;
+    uint16_t inflight;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    void *sqes;
+    _Atomic uint32_t *sqHead;
+    _Atomic uint32_t *sqTail;
+    uint32_t sqMask;
+    uint32_t *sqArray;
+    _Atomic uint32_t *cqHead;
+    _Atomic uint32_t *cqTail;
+    uint32_t cqMask;
+    void *cqes;
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t messages;
+    uint64_t shortWrites;
+    int error;
+} MCF_Uring_t;
+
+/**
+ * @brief Sets up an io_uring sink draining a ring.
+ *
+ * @param Instance   Pointer to the sink to initialize.
+ * @param Ring       Receiving MCF handle to drain.
+ * @param Fd         Destination file or socket.
+ * @param FileOffset File offset of the first message, or `MCF_URING_STREAM`.
+ * @return 0 on success, a negative errno if io_uring is unavailable.
+ */
+int MCF_uring_init(MCF_Uring_t *Instance, MCF_t *Ring, int Fd, int64_t FileOffset);
+
+/**
+ * @brief Submits newly pending messages and reaps finished writes, without blocking.
+ *
+ * Call it wherever `MCF_receive()` would be called.
+ *
+ * @param Instance Pointer to the sink.
+ * @return Messages released in this call, or -1 if a write failed (`error` is set;
+ *         the failed span stays in the ring and is retried by the next call).
+ */
+int MCF_uring_poll(MCF_Uring_t *Instance);
+
+/**
+ * @brief Waits until everything pending in the ring has been written.
+ *
+ * @param Instance Pointer to the sink.
+ * @return 0 on success, -1 if a write failed (`error` is set).
+ */
+int MCF_uring_flush(MCF_Uring_t *Instance);
+
+/**
+ * @brief Releases the io_uring instance; writes still in flight are waited for.
+ *
+ * @param Instance Pointer to the sink.
+ */
+void MCF_uring_deinit(MCF_Uring_t *Instance);
+
+#endif /* MULTICORE_FIFO_MCF_URING_H_ */
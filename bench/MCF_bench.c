@@ -0,0 +1,422 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+/** Bytes streamed by every noise thread, sized to miss in the last level cache. */
+#define MCF_BENCH_NOISE_BYTES (64u << 20)
+
+/** Upper bound of `--noise` threads. */
+#define MCF_BENCH_NOISE_MAX 64
+
+MCF_bench_options_t benchOptions = {
+    .messages = 10000000,
+    .ringSize = 1024,
+    .cpuProducer = -1,
+    .cpuConsumer = -1,
+    .regressionPct = 1.0,
+};
+
+/**
+ * @brief Benchmark mode selectable from the command line.
+ */
+typedef struct
+{
+    const char *name;
+    const char *help;
+    int (*run)(void);
+} MCF_bench_mode_t;
+
+static const MCF_bench_mode_t benchModes[] = {
+    {"throughput", "producer/consumer ns per message (packed vs padded, batch sizes)", MCF_bench_throughput},
+    {"compare", "MCF against Lamport, rigtorp-style SPSC and Vyukov MPMC queues", MCF_bench_compare},
+    {"icount", "single-threaded instructions per message, optional baseline check", MCF_bench_icount},
+    {"latency", "per-call send/receive latency histograms in CPU ticks", MCF_bench_latency},
+    {"wcet", "worst-case send/receive time from adversarial ring states", MCF_bench_wcet},
+    {"openloop", "fixed-rate sweep, latency from intended send time, saturation point", MCF_bench_openloop},
+    {"stress", "sequence-validated stress, chaos injection with -DMCF_ENABLE_CHAOS", MCF_bench_stress},
+    {"mpsc", "MCF_mpsc lanes (round-robin, ready bitmap, DRR) against a shared CAS queue", MCF_bench_mpsc},
+    {"mpmc", "MCF_mpmc fetch-and-add claiming against a CAS-claiming queue, N x N threads", MCF_bench_mpmc},
+    {"percpu", "short-lived producers: MCF_percpu rseq, spinlock fallback, shared MCF_mpmc", MCF_bench_percpu},
+    {"fanin", "consumer cost with 16-256 producers: flat polling vs MCF_fanin combiner trees", MCF_bench_fanin},
+    {"duplex", "request/response over MCF_duplex (piggybacked acks) vs two MCF rings", MCF_bench_duplex},
+    {"edf", "overloaded consumer, three latency classes: MCF_edf vs round-robin", MCF_bench_edf},
+    {"fairness", "one chatty and four quiet MCF_mpsc producers: share and latency per merge", MCF_bench_fairness},
+    {"elastic", "bursty load on MCF_mpmc: fixed consumer pools vs an MCF_elastic pool", MCF_bench_elastic},
+    {"adaptive", "receive batch limits from idle to saturation: fixed vs MCF_adaptive", MCF_bench_adaptive},
+    {"deadband", "sensor-like traffic sent directly vs through MCF_deadband, error-checked", MCF_bench_deadband},
+    {"log", "MCF_log retained log: live, late-joining (replay) and lapped readers", MCF_bench_log},
+    {"bridge", "MCF_bridge over UDP / AF_UNIX loopback: sendmmsg batching vs per-message send()", MCF_bench_bridge},
+    {"uring", "ring drained to a file and a socket: blocking write() vs MCF_uring", MCF_bench_uring},
+    {"crc", "cost of CRC32C-protected batches and detection of corrupted ones", MCF_bench_crc},
+    {"clocksync", "end-to-end latency with cross-core clock offset/drift correction", MCF_bench_clocksync},
+    {"scenario", "run --scenario description files, JSON results", MCF_bench_scenario},
+};
+
+#define MCF_BENCH_MODE_COUNT (sizeof(benchModes) / sizeof(benchModes[0]))
+
+void MCF_bench_ring_init(MCF_bench_ring_t *Ring, int padded, uint16_t size, void (*msgParser)(MCF_Message_t *msgBuf))
+{
+    uint16_t *head;
+    uint16_t *tail;
+
+    if (padded)
+    {
+        MCF_bench_ctrl_padded_t *ctrl = aligned_alloc(MCF_BENCH_CACHE_LINE, sizeof(*ctrl));
+        head = &ctrl->head;
+        tail = &ctrl->tail;
+        Ring->ctrl = ctrl;
+    }
+    else
+    {
+        MCF_bench_ctrl_packed_t *ctrl = aligned_alloc(MCF_BENCH_CACHE_LINE, MCF_BENCH_CACHE_LINE);
+        head = &ctrl->head;
+        tail = &ctrl->tail;
+        Ring->ctrl = ctrl;
+    }
+
+    size_t bufBytes = ((size * sizeof(MCF_Message_t)) + MCF_BENCH_CACHE_LINE - 1) & ~(size_t)(MCF_BENCH_CACHE_LINE - 1);
+    Ring->msgBuf = aligned_alloc(MCF_BENCH_CACHE_LINE, bufBytes);
+    memset(Ring->msgBuf, 0, bufBytes);
+
+    MCF_init_TX(&Ring->tx, head, tail, Ring->msgBuf, size);
+    MCF_init_RX(&Ring->rx, head, tail, Ring->msgBuf, size, msgParser);
+}
+
+void MCF_bench_ring_free(MCF_bench_ring_t *Ring)
+{
+    free(Ring->ctrl);
+    free(Ring->msgBuf);
+}
+
+uint16_t MCF_bench_ring_free_space(const MCF_t *Instance)
+{
+    uint16_t head = __atomic_load_n(Instance->head, __ATOMIC_RELAXED);
+    uint16_t tail = __atomic_load_n(Instance->tail, __ATOMIC_ACQUIRE);
+    uint16_t pending = (head >= tail) ? (head - tail) : (Instance->msgBufSize - tail + head);
+
+    return (uint16_t)(Instance->msgBufSize - 1 - pending);
+}
+
+uint64_t MCF_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+double MCF_bench_ticks_per_ns(void)
+{
+    static double ticksPerNs;
+
+    if (0.0 == ticksPerNs)
+    {
+        uint64_t startNs = MCF_bench_now_ns();
+        uint64_t startTicks = MCF_bench_ticks();
+
+        while (MCF_bench_now_ns() - startNs < 20000000u)
+        {
+        }
+        ticksPerNs = (double)(MCF_bench_ticks() - startTicks) / (double)(MCF_bench_now_ns() - startNs);
+    }
+    return ticksPerNs;
+}
+
+void MCF_bench_isolate(void)
+{
+    struct sched_param param = {.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1};
+
+    if (!benchOptions.isolate)
+    {
+        return;
+    }
+
+    if (0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+    {
+        fprintf(stderr, "warning: mlockall failed, page faults may show up in the tail\n");
+    }
+    if (0 != pthread_setschedparam(pthread_self(), SCHED_FIFO, &param))
+    {
+        fprintf(stderr, "warning: SCHED_FIFO not permitted, running with the default policy\n");
+    }
+}
+
+static pthread_t noiseThreads[MCF_BENCH_NOISE_MAX];
+static int noiseRunning;
+static volatile int noiseStop;
+
+static void *bench_noise(void *arg)
+{
+    uint8_t *buf = malloc(MCF_BENCH_NOISE_BYTES);
+    uint64_t round = (uintptr_t)arg;
+
+    while (!noiseStop)
+    {
+        for (size_t i = 0; i < MCF_BENCH_NOISE_BYTES; i += MCF_BENCH_CACHE_LINE)
+        {
+            buf[i] = (uint8_t)(round + i);
+        }
+        round++;
+    }
+    free(buf);
+    return NULL;
+}
+
+void MCF_bench_noise_start(void)
+{
+    noiseStop = 0;
+    noiseRunning = (benchOptions.noiseThreads < MCF_BENCH_NOISE_MAX) ? benchOptions.noiseThreads : MCF_BENCH_NOISE_MAX;
+    for (int i = 0; i < noiseRunning; i++)
+    {
+        pthread_create(&noiseThreads[i], NULL, bench_noise, (void *)(uintptr_t)i);
+    }
+}
+
+void MCF_bench_noise_stop(void)
+{
+    noiseStop = 1;
+    for (int i = 0; i < noiseRunning; i++)
+    {
+        pthread_join(noiseThreads[i], NULL);
+    }
+    noiseRunning = 0;
+}
+
+void MCF_bench_pin(int cpu)
+{
+    cpu_set_t set;
+
+    if (0 > cpu)
+    {
+        return;
+    }
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (0 != pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+    {
+        fprintf(stderr, "warning: cannot pin thread to CPU %d\n", cpu);
+    }
+}
+
+void MCF_bench_relax(uint32_t *spins)
+{
+    if (0 == (++(*spins) & 0x3ff))
+    {
+        sched_yield();
+    }
+    else
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ volatile("yield");
+#endif
+    }
+}
+
+void MCF_bench_print_counters_header(void)
+{
+    if (!MCF_perf_enabled())
+    {
+        return;
+    }
+
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        printf(" %9s/msg", MCF_perf_name((MCF_perf_event_t)i));
+    }
+}
+
+void MCF_bench_print_counters(const MCF_perf_t *perf, uint64_t messages)
+{
+    if (!MCF_perf_enabled())
+    {
+        return;
+    }
+
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        if (MCF_perf_available(perf, (MCF_perf_event_t)i) && (0 < messages))
+        {
+            printf(" %13.3f", (double)perf->value[i] / (double)messages);
+        }
+        else
+        {
+            printf(" %13s", "n/a");
+        }
+    }
+}
+
+static void bench_usage(const char *prog)
+{
+    printf("usage: %s [options] [mode...]\n\n", prog);
+    printf("modes (default: all):\n");
+    for (size_t i = 0; i < MCF_BENCH_MODE_COUNT; i++)
+    {
+        printf("  %-12s %s\n", benchModes[i].name, benchModes[i].help);
+    }
+    printf("\noptions:\n");
+    printf("  -n, --messages N         messages per scenario (default %u)\n", benchOptions.messages);
+    printf("  -s, --ring-size N        ring capacity in messages (default %u)\n", benchOptions.ringSize);
+    printf("  -c, --cpus P,C           pin producer and consumer threads\n");
+    printf("  -p, --perf               collect cycles, instructions and cache misses per message\n");
+    printf("      --hitm-raw HEX       raw perf event counting HITM loads (implies --perf)\n");
+    printf("      --save-baseline FILE store icount results\n");
+    printf("      --baseline FILE      compare icount results, fail on regression\n");
+    printf("      --threshold PCT      allowed instructions/msg growth (default %.1f%%)\n",
+           benchOptions.regressionPct);
+    printf("      --isolate            SCHED_FIFO and mlockall for measuring threads\n");
+    printf("      --noise N            N background threads thrashing the caches\n");
+    printf("  -r, --rates LIST         open-loop target rates in msg/s, e.g. 1e5,1e6,5e6\n");
+    printf("  -f, --scenario FILE      scenario description to run (repeatable)\n");
+    printf("  -o, --output FILE        write JSON results to FILE\n");
+    printf("  -h, --help               show this help\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option longOptions[] = {
+        {"messages", required_argument, NULL, 'n'},
+        {"ring-size", required_argument, NULL, 's'},
+        {"cpus", required_argument, NULL, 'c'},
+        {"perf", no_argument, NULL, 'p'},
+        {"hitm-raw", required_argument, NULL, 'H'},
+        {"save-baseline", required_argument, NULL, 'S'},
+        {"baseline", required_argument, NULL, 'B'},
+        {"threshold", required_argument, NULL, 'T'},
+        {"isolate", no_argument, NULL, 'I'},
+        {"noise", required_argument, NULL, 'N'},
+        {"rates", required_argument, NULL, 'r'},
+        {"scenario", required_argument, NULL, 'f'},
+        {"output", required_argument, NULL, 'o'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    int result = 0;
+
+    while (-1 != (opt = getopt_long(argc, argv, "n:s:c:pr:f:o:h", longOptions, NULL)))
+    {
+        switch (opt) {
+        case 'n':
+            benchOptions.messages = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            benchOptions.ringSize = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            if (2 != sscanf(optarg, "%d,%d", &benchOptions.cpuProducer, &benchOptions.cpuConsumer))
+            {
+                fprintf(stderr, "invalid --cpus value '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'p':
+            MCF_perf_enable(0);
+            break;
+        case 'H':
+            MCF_perf_enable(strtoull(optarg, NULL, 16));
+            break;
+        case 'S':
+            benchOptions.saveBaselineFile = optarg;
+            break;
+        case 'B':
+            benchOptions.baselineFile = optarg;
+            break;
+        case 'T':
+            benchOptions.regressionPct = strtod(optarg, NULL);
+            break;
+        case 'I':
+            benchOptions.isolate = 1;
+            break;
+        case 'N':
+            benchOptions.noiseThreads = (int)strtol(optarg, NULL, 0);
+            break;
+        case 'r':
+            benchOptions.rateCount = 0;
+            for (char *item = strtok(optarg, ","); (NULL != item) && (MCF_BENCH_MAX_RATES > benchOptions.rateCount);
+                 item = strtok(NULL, ","))
+            {
+                double rate = strtod(item, NULL);
+
+                if (0.0 >= rate)
+                {
+                    fprintf(stderr, "invalid rate '%s'\n", item);
+                    return 2;
+                }
+                benchOptions.rates[benchOptions.rateCount++] = rate;
+            }
+            break;
+        case 'f':
+            if (MCF_BENCH_MAX_SCENARIOS <= benchOptions.scenarioCount)
+            {
+                fprintf(stderr, "too many scenario files\n");
+                return 2;
+            }
+            benchOptions.scenarioFiles[benchOptions.scenarioCount++] = optarg;
+            break;
+        case 'o':
+            benchOptions.outputFile = optarg;
+            break;
+        case 'h':
+            bench_usage(argv[0]);
+            return 0;
+        default:
+            bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if ((2 > benchOptions.ringSize) || (0 == benchOptions.messages))
+    {
+        fprintf(stderr, "ring size must be at least 2 and message count non-zero\n");
+        return 2;
+    }
+
+    for (size_t i = 0; i < MCF_BENCH_MODE_COUNT; i++)
+    {
+        /* Scenario files alone select just the scenario mode. */
+        int selected = (optind >= argc) &&
+                       ((0 == benchOptions.scenarioCount) || (benchModes[i].run == MCF_bench_scenario));
+
+        for (int arg = optind; arg < argc; arg++)
+        {
+            selected |= (0 == strcmp(argv[arg], benchModes[i].name));
+        }
+
+        /* Scenario results on stdout are a JSON document; a mode header would break it. */
+        int json = (benchModes[i].run == MCF_bench_scenario) && (0 != benchOptions.scenarioCount) &&
+                   (NULL == benchOptions.outputFile);
+
+        if (selected && json)
+        {
+            result |= benchModes[i].run();
+        }
+        else if (selected)
+        {
+            printf("== %s ==\n", benchModes[i].name);
+            result |= benchModes[i].run();
+            printf("\n");
+        }
+    }
+
+    return result;
+}
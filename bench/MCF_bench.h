@@ -0,0 +1,222 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_BENCH_H_
+#define MULTICORE_FIFO_MCF_BENCH_H_
+
+/*
+ * Host benchmark harness for MCF (Linux, pthreads).
+ *
+ * There is no build script; compile it together with the library sources:
+ *
+ *     cc -O2 -pthread -I. MCF*.c bench/MCF_bench*.c -lm -o mcf_bench
+ *
+ * and run `./mcf_bench --help` for the available modes and options.
+ */
+
+#include "MCF.h"
+#include "MCF_bench_perf.h"
+#include <stdint.h>
+
+#define MCF_BENCH_CACHE_LINE 64
+
+/** Upper bound of `--scenario` files per run. */
+#define MCF_BENCH_MAX_SCENARIOS 32
+
+/** Upper bound of `--rates` points per sweep. */
+#define MCF_BENCH_MAX_RATES 32
+
+/**
+ * @brief Head and tail indices sharing one cache line, as they usually end up
+ *        when placed next to each other in shared SRAM.
+ */
+typedef struct
+{
+    uint16_t head;
+    uint16_t tail;
+} MCF_bench_ctrl_packed_t;
+
+/**
+ * @brief Head and tail indices on separate cache lines, so the producer and the
+ *        consumer only write lines they own.
+ */
+typedef struct
+{
+    _Alignas(MCF_BENCH_CACHE_LINE) uint16_t head;
+    _Alignas(MCF_BENCH_CACHE_LINE) uint16_t tail;
+} MCF_bench_ctrl_padded_t;
+
+/**
+ * @brief Shared ring used by one producer/consumer pair.
+ *
+ * - `tx`: Producer side handle.
+ * - `rx`: Consumer side handle.
+ * - `ctrl`: Storage of the head and tail indices (packed or padded layout).
+ * - `msgBuf`: Message buffer of `msgBufSize` elements.
+ */
+typedef struct
+{
+    MCF_t tx;
+    MCF_t rx;
+    void *ctrl;
+    MCF_Message_t *msgBuf;
+} MCF_bench_ring_t;
+
+/**
+ * @brief Command line options shared by all benchmark modes.
+ *
+ * - `messages`: Messages transferred per scenario.
+ * - `ringSize`: Ring capacity in messages (`msgBufSize`).
+ * - `cpuProducer`, `cpuConsumer`: CPUs to pin the threads to, -1 to leave unpinned.
+ * - `baselineFile`: Results to compare the instruction counts against, or NULL.
+ * - `saveBaselineFile`: File to store the instruction counts in, or NULL.
+ * - `regressionPct`: Allowed growth of instructions per message over the baseline.
+ * - `isolate`: Lock memory and run measuring threads under SCHED_FIFO.
+ * - `noiseThreads`: Background threads thrashing memory while measuring.
+ * - `scenarioFiles`, `scenarioCount`: Scenario descriptions run by the scenario mode.
+ * - `outputFile`: File receiving machine readable (JSON) results, NULL for stdout.
+ * - `rates`, `rateCount`: Target rates (messages/s) of the open-loop sweep, defaults when empty.
+ */
+typedef struct
+{
+    uint32_t messages;
+    uint16_t ringSize;
+    int cpuProducer;
+    int cpuConsumer;
+    const char *baselineFile;
+    const char *saveBaselineFile;
+    double regressionPct;
+    int isolate;
+    int noiseThreads;
+    const char *scenarioFiles[MCF_BENCH_MAX_SCENARIOS];
+    int scenarioCount;
+    const char *outputFile;
+    double rates[MCF_BENCH_MAX_RATES];
+    int rateCount;
+} MCF_bench_options_t;
+
+extern MCF_bench_options_t benchOptions;
+
+/**
+ * @brief Allocates a ring and initializes its TX and RX handles.
+ *
+ * @param Ring      Ring to set up.
+ * @param padded    Non-zero to place head and tail on separate cache lines.
+ * @param size      Ring capacity in messages.
+ * @param msgParser Parser invoked by `MCF_receive()` on the RX handle.
+ */
+void MCF_bench_ring_init(MCF_bench_ring_t *Ring, int padded, uint16_t size, void (*msgParser)(MCF_Message_t *msgBuf));
+
+/**
+ * @brief Releases memory allocated by `MCF_bench_ring_init()`.
+ */
+void MCF_bench_ring_free(MCF_bench_ring_t *Ring);
+
+/**
+ * @brief Returns how many messages the producer can send without overwriting unread ones.
+ *
+ * MCF itself never refuses a send, so the benchmarks apply the flow control a real
+ * producer is expected to do.
+ */
+uint16_t MCF_bench_ring_free_space(const MCF_t *Instance);
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+uint64_t MCF_bench_now_ns(void);
+
+/**
+ * @brief Reads the CPU cycle counter (TSC on x86, CNTVCT on AArch64).
+ *
+ * The read is serialized against earlier instructions so it brackets a single
+ * call tightly. Falls back to the monotonic clock on other targets.
+ */
+static inline uint64_t MCF_bench_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_lfence();
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks)::"memory");
+    return ticks;
+#else
+    return MCF_bench_now_ns();
+#endif
+}
+
+/**
+ * @brief Returns the `MCF_bench_ticks()` rate, calibrated once against the monotonic clock.
+ */
+double MCF_bench_ticks_per_ns(void);
+
+/**
+ * @brief Applies `--isolate` to the calling thread: SCHED_FIFO and locked memory.
+ */
+void MCF_bench_isolate(void);
+
+/**
+ * @brief Starts `--noise` background threads streaming over a buffer larger than the LLC.
+ */
+void MCF_bench_noise_start(void);
+
+/**
+ * @brief Stops the background threads started by `MCF_bench_noise_start()`.
+ */
+void MCF_bench_noise_stop(void);
+
+/**
+ * @brief Pins the calling thread to `cpu` (no-op for negative values).
+ */
+void MCF_bench_pin(int cpu);
+
+/**
+ * @brief Busy-wait hint, yielding now and then so waits progress on a single CPU.
+ */
+void MCF_bench_relax(uint32_t *spins);
+
+/**
+ * @brief Prints the per-message counter columns of a merged counter set.
+ */
+void MCF_bench_print_counters(const MCF_perf_t *perf, uint64_t messages);
+
+/**
+ * @brief Prints the header matching `MCF_bench_print_counters()`.
+ */
+void MCF_bench_print_counters_header(void);
+
+/**
+ * @brief Benchmark modes, each returns non-zero when a run detected an error.
+ */
+int MCF_bench_throughput(void);
+int MCF_bench_compare(void);
+int MCF_bench_icount(void);
+int MCF_bench_latency(void);
+int MCF_bench_wcet(void);
+int MCF_bench_scenario(void);
+int MCF_bench_openloop(void);
+int MCF_bench_stress(void);
+int MCF_bench_clocksync(void);
+int MCF_bench_mpsc(void);
+int MCF_bench_mpmc(void);
+int MCF_bench_percpu(void);
+int MCF_bench_fanin(void);
+int MCF_bench_duplex(void);
+int MCF_bench_edf(void);
+int MCF_bench_fairness(void);
+int MCF_bench_elastic(void);
+int MCF_bench_adaptive(void);
+int MCF_bench_deadband(void);
+int MCF_bench_log(void);
+int MCF_bench_bridge(void);
+int MCF_bench_uring(void);
+int MCF_bench_crc(void);
+
+#endif /* MULTICORE_FIFO_MCF_BENCH_H_ */
@@ -0,0 +1,224 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Receive loop batching from idle to saturation.
+ *
+ * The consumer runs a main loop that, besides draining one ring, does
+ * ADAPTIVE_HOUSEKEEPING_NS of other work per iteration. Batches of one message
+ * pay that work per message, unbounded batches delay it by a whole backlog.
+ * Fixed batch limits are compared with MCF_adaptive at several offered loads;
+ * the report shows message latency, throughput, the longest main-loop iteration,
+ * and the batch limit and tail-publish interval MCF_adaptive settled on (fixed
+ * limits publish after every message). Messages are sequence-checked.
+ */
+
+#include "MCF_adaptive.h"
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ADAPTIVE_RUN_NS 300000000ull
+#define ADAPTIVE_PARSE_NS 200u
+#define ADAPTIVE_HOUSEKEEPING_NS 1000u
+#define ADAPTIVE_TARGET_NS 20000u
+#define ADAPTIVE_MAX_BATCH 1024u
+
+/** Producer send periods; 0 sends as fast as the ring allows. */
+static const uint32_t adaptivePeriodsNs[] = {10000u, 1000u, 400u, 0u};
+
+typedef enum
+{
+    ADAPTIVE_FIXED_1 = 0,
+    ADAPTIVE_FIXED_MAX,
+    ADAPTIVE_ADAPTIVE,
+    ADAPTIVE_VARIANT_COUNT
+} adaptive_variant_t;
+
+static const char *const adaptiveVariantNames[ADAPTIVE_VARIANT_COUNT] = {"fixed-1", "fixed-1024", "adaptive"};
+
+typedef struct
+{
+    adaptive_variant_t variant;
+    uint32_t periodNs;
+    MCF_bench_ring_t ring;
+    MCF_Adaptive_t adaptive;
+    pthread_barrier_t start;
+    uint64_t elapsedNs;
+    uint64_t maxLoopNs;
+    volatile int stop;
+} adaptive_run_t;
+
+static MCF_hist_t *adaptiveLatency;
+static uint32_t adaptiveExpected;
+static uint64_t adaptiveErrors;
+
+static uint32_t adaptive_now(void)
+{
+    return (uint32_t)MCF_bench_now_ns();
+}
+
+static void adaptive_busy(uint32_t ns)
+{
+    uint64_t end = MCF_bench_now_ns() + ns;
+
+    while (MCF_bench_now_ns() < end)
+    {
+    }
+}
+
+static void adaptive_parser(MCF_Message_t *msgBuf)
+{
+    MCF_hist_record(adaptiveLatency, adaptive_now() - msgBuf->u32);
+    if (msgBuf->msgID != (uint16_t)adaptiveExpected)
+    {
+        adaptiveErrors++;
+    }
+    adaptiveExpected++;
+    adaptive_busy(ADAPTIVE_PARSE_NS);
+}
+
+static void *adaptive_producer(void *arg)
+{
+    adaptive_run_t *run = arg;
+    MCF_t *tx = &run->ring.tx;
+    uint16_t seq = 0;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    uint64_t next = MCF_bench_now_ns();
+
+    while (!run->stop)
+    {
+        if ((0u != run->periodNs) && (MCF_bench_now_ns() < next))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+        if (0u == MCF_get_free(tx))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+        MCF_send_u32(tx, seq++, adaptive_now());
+        next += run->periodNs;
+    }
+    return NULL;
+}
+
+static void *adaptive_consumer(void *arg)
+{
+    adaptive_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    uint64_t startNs = MCF_bench_now_ns();
+    uint64_t last = startNs;
+    while (last - startNs < ADAPTIVE_RUN_NS)
+    {
+        uint16_t received;
+
+        switch (run->variant) {
+        case ADAPTIVE_FIXED_1:
+            received = MCF_receive_n(&run->ring.rx, 1);
+            break;
+        case ADAPTIVE_FIXED_MAX:
+            received = MCF_receive_n(&run->ring.rx, ADAPTIVE_MAX_BATCH);
+            break;
+        case ADAPTIVE_ADAPTIVE:
+        default:
+            received = MCF_adaptive_receive(&run->adaptive);
+            break;
+        }
+        if (0u == received)
+        {
+            MCF_bench_relax(&spins);
+        }
+        adaptive_busy(ADAPTIVE_HOUSEKEEPING_NS);
+
+        uint64_t now = MCF_bench_now_ns();
+        if (now - last > run->maxLoopNs)
+        {
+            run->maxLoopNs = now - last;
+        }
+        last = now;
+    }
+    run->stop = 1;
+    run->elapsedNs = last - startNs;
+    return NULL;
+}
+
+int MCF_bench_adaptive(void)
+{
+    int result = 0;
+
+    printf("parse %u ns/msg, housekeeping %u ns/iteration, target %u ns/call\n", ADAPTIVE_PARSE_NS,
+           ADAPTIVE_HOUSEKEEPING_NS, ADAPTIVE_TARGET_NS);
+    printf("%-12s %-10s %10s %10s %10s %14s %8s %8s %8s\n", "offered", "receive", "Mmsg/s", "p50 us", "p99 us",
+           "max loop us", "batch", "publish", "errors");
+
+    for (size_t p = 0; p < sizeof(adaptivePeriodsNs) / sizeof(adaptivePeriodsNs[0]); p++)
+    {
+        char offered[16];
+
+        if (0u == adaptivePeriodsNs[p])
+        {
+            snprintf(offered, sizeof(offered), "saturated");
+        }
+        else
+        {
+            snprintf(offered, sizeof(offered), "%.2f Mmsg/s", 1e3 / (double)adaptivePeriodsNs[p]);
+        }
+
+        for (int variant = 0; variant < ADAPTIVE_VARIANT_COUNT; variant++)
+        {
+            adaptive_run_t *run = calloc(1, sizeof(*run));
+            pthread_t producer;
+            pthread_t consumer;
+
+            run->variant = (adaptive_variant_t)variant;
+            run->periodNs = adaptivePeriodsNs[p];
+            MCF_bench_ring_init(&run->ring, 1, benchOptions.ringSize, adaptive_parser);
+            MCF_adaptive_init(&run->adaptive, &run->ring.rx, adaptive_now, ADAPTIVE_TARGET_NS, 1,
+                              ADAPTIVE_MAX_BATCH);
+            pthread_barrier_init(&run->start, NULL, 2);
+            adaptiveLatency = malloc(sizeof(MCF_hist_t));
+            MCF_hist_reset(adaptiveLatency);
+            adaptiveExpected = 0;
+            adaptiveErrors = 0;
+
+            pthread_create(&consumer, NULL, adaptive_consumer, run);
+            pthread_create(&producer, NULL, adaptive_producer, run);
+            pthread_join(consumer, NULL);
+            pthread_join(producer, NULL);
+
+            printf("%-12s %-10s %10.3f %10.1f %10.1f %14.1f %8u %8u %8llu\n", offered, adaptiveVariantNames[variant],
+                   (double)adaptiveLatency->count * 1e3 / (double)run->elapsedNs,
+                   (double)MCF_hist_percentile(adaptiveLatency, 50.0) / 1e3,
+                   (double)MCF_hist_percentile(adaptiveLatency, 99.0) / 1e3, (double)run->maxLoopNs / 1e3,
+                   (ADAPTIVE_ADAPTIVE == run->variant) ? run->adaptive.batch : 0u,
+                   (ADAPTIVE_ADAPTIVE == run->variant) ? run->adaptive.publishInterval : 1u,
+                   (unsigned long long)adaptiveErrors);
+            result |= (0u != adaptiveErrors);
+
+            free(adaptiveLatency);
+            pthread_barrier_destroy(&run->start);
+            MCF_bench_ring_free(&run->ring);
+            free(run);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,318 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * An MCF stream carried over a local socket by MCF_bridge.
+ *
+ *     producer -> ring A -> forwarder -> socket -> receiver -> ring B -> check
+ *
+ * The forwarder either runs MCF_bridge_send() (batched sendmmsg() straight from
+ * the ring) or, as the baseline, MCF_receive() with a parser that send()s every
+ * message as its own datagram. The receiver always uses MCF_bridge_receive()
+ * and checks that ring B delivers the stream in order without duplicates. UDP
+ * may drop datagrams when the receiver falls behind; such gaps are reported,
+ * while the AF_UNIX transports must be lossless.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_bridge.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Messages per run; the per-message baseline makes one syscall each. */
+#define BRIDGE_MAX_MESSAGES 1000000u
+
+/** Receiver gives up this long after the forwarder finished and nothing arrived. */
+#define BRIDGE_IDLE_NS 50000000ull
+
+typedef enum
+{
+    BRIDGE_UDP_PER_MESSAGE = 0,
+    BRIDGE_UDP,
+    BRIDGE_UNIX_DGRAM,
+    BRIDGE_UNIX_SEQPACKET,
+    BRIDGE_VARIANT_COUNT
+} bridge_variant_t;
+
+static const char *const bridgeVariantNames[BRIDGE_VARIANT_COUNT] = {"udp-per-msg", "udp-sendmmsg",
+                                                                      "unix-dgram", "unix-seqpacket"};
+
+typedef struct
+{
+    bridge_variant_t variant;
+    uint32_t messages;
+    MCF_bench_ring_t ringA;
+    MCF_bench_ring_t ringB;
+    MCF_Bridge_t sender;
+    MCF_Bridge_t receiver;
+    int txFd;
+    int rxFd;
+    uint32_t perMessageSeq;
+    uint64_t syscalls;
+    pthread_barrier_t start;
+    volatile int producerDone;
+    volatile int forwarderDone;
+} bridge_run_t;
+
+static bridge_run_t *bridgeRun;
+static uint64_t bridgeDelivered;
+static uint64_t bridgeGaps;
+static uint64_t bridgeErrors;
+static uint32_t bridgeNext;
+
+static void bridge_check_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 < bridgeNext)
+    {
+        bridgeErrors++;
+    }
+    else
+    {
+        bridgeGaps += msgBuf->u32 - bridgeNext;
+        bridgeNext = msgBuf->u32 + 1u;
+    }
+    bridgeDelivered++;
+}
+
+static void bridge_per_message_parser(MCF_Message_t *msgBuf)
+{
+    struct
+    {
+        MCF_BridgeHeader_t header;
+        MCF_Message_t msg;
+    } datagram = {{.seq = bridgeRun->perMessageSeq, .count = 1}, *msgBuf};
+    uint32_t spins = 0;
+
+    while (0 > send(bridgeRun->txFd, &datagram, sizeof(datagram), 0))
+    {
+        MCF_bench_relax(&spins);
+    }
+    bridgeRun->perMessageSeq++;
+    bridgeRun->syscalls++;
+}
+
+static void *bridge_producer(void *arg)
+{
+    bridge_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    for (uint32_t i = 0; i < run->messages; i++)
+    {
+        while (0u == MCF_get_free(&run->ringA.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+        MCF_send_u32(&run->ringA.tx, 1, i);
+    }
+    run->producerDone = 1;
+    return NULL;
+}
+
+static void *bridge_forwarder(void *arg)
+{
+    bridge_run_t *run = arg;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    for (;;)
+    {
+        int done = run->producerDone;
+        int sent;
+
+        if (BRIDGE_UDP_PER_MESSAGE == run->variant)
+        {
+            sent = MCF_receive_n(&run->ringA.rx, UINT16_MAX);
+        }
+        else
+        {
+            uint64_t before = run->sender.datagrams;
+
+            sent = MCF_bridge_send(&run->sender);
+            run->syscalls += (run->sender.datagrams != before);
+        }
+        if (0 > sent)
+        {
+            perror("bridge send");
+            break;
+        }
+        if (done && (0u == MCF_get_pending(&run->ringA.rx)))
+        {
+            break;
+        }
+        if (0 == sent)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->forwarderDone = 1;
+    return NULL;
+}
+
+static void *bridge_receiver(void *arg)
+{
+    bridge_run_t *run = arg;
+    uint32_t spins = 0;
+    uint64_t idleSince = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+    while (bridgeDelivered < run->messages)
+    {
+        int injected = MCF_bridge_receive(&run->receiver);
+
+        if (0 > injected)
+        {
+            perror("bridge receive");
+            break;
+        }
+        MCF_receive(&run->ringB.rx);
+        if (0 < injected)
+        {
+            idleSince = 0;
+            continue;
+        }
+        if (run->forwarderDone)
+        {
+            uint64_t now = MCF_bench_now_ns();
+
+            if (0u == idleSince)
+            {
+                idleSince = now;
+            }
+            else if (now - idleSince > BRIDGE_IDLE_NS)
+            {
+                break;
+            }
+        }
+        MCF_bench_relax(&spins);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Creates a connected socket pair for the transport; returns 0 on success.
+ */
+static int bridge_sockets(bridge_variant_t variant, int *txFd, int *rxFd)
+{
+    int fds[2];
+
+    if (BRIDGE_UNIX_DGRAM == variant || BRIDGE_UNIX_SEQPACKET == variant)
+    {
+        if (0 != socketpair(AF_UNIX, (BRIDGE_UNIX_DGRAM == variant) ? SOCK_DGRAM : SOCK_SEQPACKET, 0, fds))
+        {
+            return -1;
+        }
+        *txFd = fds[0];
+        *rxFd = fds[1];
+        return 0;
+    }
+
+    struct sockaddr_in rxAddr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    struct sockaddr_in txAddr = rxAddr;
+    socklen_t length = sizeof(rxAddr);
+    int rcvbuf = 4 << 20;
+
+    *rxFd = socket(AF_INET, SOCK_DGRAM, 0);
+    *txFd = socket(AF_INET, SOCK_DGRAM, 0);
+    if ((0 > *rxFd) || (0 > *txFd))
+    {
+        return -1;
+    }
+    setsockopt(*rxFd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    if ((0 != bind(*rxFd, (struct sockaddr *)&rxAddr, sizeof(rxAddr))) ||
+        (0 != getsockname(*rxFd, (struct sockaddr *)&rxAddr, &length)) ||
+        (0 != bind(*txFd, (struct sockaddr *)&txAddr, sizeof(txAddr))) ||
+        (0 != getsockname(*txFd, (struct sockaddr *)&txAddr, &length)) ||
+        (0 != connect(*txFd, (struct sockaddr *)&rxAddr, sizeof(rxAddr))) ||
+        (0 != connect(*rxFd, (struct sockaddr *)&txAddr, sizeof(txAddr))))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int MCF_bench_bridge(void)
+{
+    uint32_t messages = (benchOptions.messages < BRIDGE_MAX_MESSAGES) ? benchOptions.messages : BRIDGE_MAX_MESSAGES;
+    int result = 0;
+
+    printf("%u messages per transport\n", messages);
+    printf("%-15s %10s %10s %12s %10s %10s %10s %8s\n", "transport", "Mmsg/s", "delivered", "send calls", "gaps",
+           "dropped", "malformed", "errors");
+
+    for (int variant = 0; variant < BRIDGE_VARIANT_COUNT; variant++)
+    {
+        bridge_run_t *run = calloc(1, sizeof(*run));
+        pthread_t producer;
+        pthread_t forwarder;
+        pthread_t receiver;
+
+        run->variant = (bridge_variant_t)variant;
+        run->messages = messages;
+        if (0 != bridge_sockets(run->variant, &run->txFd, &run->rxFd))
+        {
+            perror("bridge sockets");
+            free(run);
+            result = 1;
+            continue;
+        }
+        MCF_bench_ring_init(&run->ringA, 1, benchOptions.ringSize, bridge_per_message_parser);
+        MCF_bench_ring_init(&run->ringB, 1, benchOptions.ringSize, bridge_check_parser);
+        MCF_bridge_init(&run->sender, &run->ringA.rx, run->txFd);
+        MCF_bridge_init(&run->receiver, &run->ringB.tx, run->rxFd);
+        pthread_barrier_init(&run->start, NULL, 3);
+        bridgeRun = run;
+        bridgeDelivered = 0;
+        bridgeGaps = 0;
+        bridgeErrors = 0;
+        bridgeNext = 0;
+
+        uint64_t startNs = MCF_bench_now_ns();
+        pthread_create(&receiver, NULL, bridge_receiver, run);
+        pthread_create(&forwarder, NULL, bridge_forwarder, run);
+        pthread_create(&producer, NULL, bridge_producer, run);
+        pthread_join(producer, NULL);
+        pthread_join(forwarder, NULL);
+        pthread_join(receiver, NULL);
+        uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+        /* Messages missing at the end of the stream are gaps as well. */
+        bridgeGaps += messages - bridgeNext;
+        uint64_t errors = bridgeErrors + run->receiver.malformed;
+        if ((BRIDGE_UDP != run->variant) && (BRIDGE_UDP_PER_MESSAGE != run->variant))
+        {
+            errors += bridgeGaps + run->receiver.dropped;
+        }
+
+        printf("%-15s %10.3f %10llu %12llu %10llu %10llu %10llu %8llu\n", bridgeVariantNames[variant],
+               (double)bridgeDelivered * 1e3 / (double)elapsedNs, (unsigned long long)bridgeDelivered,
+               (unsigned long long)run->syscalls, (unsigned long long)bridgeGaps,
+               (unsigned long long)run->receiver.dropped, (unsigned long long)run->receiver.malformed,
+               (unsigned long long)errors);
+        result |= (0u != errors);
+
+        pthread_barrier_destroy(&run->start);
+        close(run->txFd);
+        close(run->rxFd);
+        MCF_bench_ring_free(&run->ringA);
+        MCF_bench_ring_free(&run->ringB);
+        free(run);
+    }
+
+    return result;
+}
@@ -0,0 +1,221 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * End-to-end latency with producer-side cycle counter timestamps.
+ *
+ * The producer stamps each message with its own cycle counter; the consumer
+ * compares it with its own. Before the run, MCF_clock calibrates the offset and
+ * drift between the two cores over a dedicated ring pair, and latencies are
+ * reported both raw and corrected. Pin the threads (--cpus) so the estimate
+ * belongs to a fixed core pair.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include "MCF_clock.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Ping-pong exchanges per calibration. */
+#define CLOCKSYNC_EXCHANGES 2000u
+
+/** Time between the two calibrations that estimate drift. */
+#define CLOCKSYNC_DRIFT_WINDOW_NS 200000000ull
+
+typedef struct
+{
+    MCF_bench_ring_t data;
+    MCF_bench_ring_t ping;
+    MCF_bench_ring_t pong;
+    pthread_barrier_t start;
+    volatile int calibrated;
+    uint64_t *stamps;
+    uint32_t stampMask;
+    MCF_ClockSync_t sync;
+    MCF_hist_t *raw;
+    MCF_hist_t *corrected;
+    int64_t negative;
+    int64_t beyondBound;
+} clocksync_run_t;
+
+static clocksync_run_t *clocksyncRun;
+static uint32_t clocksyncReceived;
+
+static uint64_t clocksync_ticks(void)
+{
+    return MCF_bench_ticks();
+}
+
+static void clocksync_parser(MCF_Message_t *msgBuf)
+{
+    uint64_t now = MCF_bench_ticks();
+    uint64_t sent = clocksyncRun->stamps[msgBuf->u32 & clocksyncRun->stampMask];
+    uint64_t local = MCF_clock_to_local(&clocksyncRun->sync, sent);
+
+    MCF_hist_record(clocksyncRun->raw, now - sent);
+    if (now >= local)
+    {
+        MCF_hist_record(clocksyncRun->corrected, now - local);
+    }
+    else
+    {
+        /* Residual error of the estimate; counted, not recorded as a huge latency. */
+        clocksyncRun->negative++;
+        if (local - now > clocksyncRun->sync.rtt / 2u)
+        {
+            clocksyncRun->beyondBound++;
+        }
+    }
+    clocksyncReceived++;
+}
+
+static void clocksync_unused_parser(MCF_Message_t *msgBuf)
+{
+    (void)msgBuf;
+}
+
+static void *clocksync_producer(void *arg)
+{
+    clocksync_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    MCF_clock_bind_remote(&run->pong.tx, &run->ping.rx, clocksync_ticks);
+    pthread_barrier_wait(&run->start);
+
+    while (!run->calibrated)
+    {
+        MCF_clock_respond();
+    }
+
+    for (uint32_t seq = 0; seq < benchOptions.messages; seq++)
+    {
+        while (0 == MCF_bench_ring_free_space(&run->data.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+        run->stamps[seq & run->stampMask] = MCF_bench_ticks();
+        MCF_send_u32(&run->data.tx, 1, seq);
+    }
+    return NULL;
+}
+
+static void *clocksync_consumer(void *arg)
+{
+    clocksync_run_t *run = arg;
+    uint64_t timeout = (uint64_t)(MCF_bench_ticks_per_ns() * 10e6);
+    uint32_t spins = 0;
+    int result;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    MCF_clock_bind_local(&run->ping.tx, &run->pong.rx, clocksync_ticks);
+    pthread_barrier_wait(&run->start);
+
+    result = MCF_clock_calibrate(&run->sync, CLOCKSYNC_EXCHANGES, timeout);
+    uint64_t waitStart = MCF_bench_now_ns();
+    while (MCF_bench_now_ns() - waitStart < CLOCKSYNC_DRIFT_WINDOW_NS)
+    {
+        MCF_bench_relax(&spins);
+    }
+    result |= MCF_clock_calibrate(&run->sync, CLOCKSYNC_EXCHANGES, timeout);
+    run->calibrated = 1;
+
+    if (0 != result)
+    {
+        fprintf(stderr, "clocksync: calibration timed out, latencies are uncorrected\n");
+    }
+
+    while (clocksyncReceived < benchOptions.messages)
+    {
+        uint32_t before = clocksyncReceived;
+
+        MCF_receive(&run->data.rx);
+        if (before == clocksyncReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void clocksync_print(const char *name, const MCF_hist_t *hist, double ticksPerNs)
+{
+    if (0 == hist->count)
+    {
+        printf("%-10s %12s %12s %12s %12s\n", name, "n/a", "n/a", "n/a", "n/a");
+        return;
+    }
+    printf("%-10s %12.1f %12.1f %12.1f %12.1f\n", name, (double)hist->min / ticksPerNs,
+           (double)MCF_hist_percentile(hist, 50.0) / ticksPerNs, (double)MCF_hist_percentile(hist, 99.0) / ticksPerNs,
+           (double)hist->max / ticksPerNs);
+}
+
+int MCF_bench_clocksync(void)
+{
+    clocksync_run_t run = {0};
+    double ticksPerNs = MCF_bench_ticks_per_ns();
+    uint32_t tableSize = 1;
+    pthread_t producer;
+    pthread_t consumer;
+
+    while (tableSize < 2u * benchOptions.ringSize)
+    {
+        tableSize <<= 1;
+    }
+    run.stampMask = tableSize - 1u;
+    run.stamps = calloc(tableSize, sizeof(*run.stamps));
+    run.raw = malloc(sizeof(*run.raw));
+    run.corrected = malloc(sizeof(*run.corrected));
+    MCF_hist_reset(run.raw);
+    MCF_hist_reset(run.corrected);
+
+    clocksyncRun = &run;
+    clocksyncReceived = 0;
+    MCF_bench_ring_init(&run.data, 1, benchOptions.ringSize, clocksync_parser);
+    MCF_bench_ring_init(&run.ping, 1, 16, clocksync_unused_parser);
+    MCF_bench_ring_init(&run.pong, 1, 16, clocksync_unused_parser);
+    pthread_barrier_init(&run.start, NULL, 2);
+
+    pthread_create(&consumer, NULL, clocksync_consumer, &run);
+    pthread_create(&producer, NULL, clocksync_producer, &run);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("offset %lld ticks (+/- %.1f ns), drift %lld ppb\n", (long long)run.sync.offset,
+           (double)run.sync.rtt / 2.0 / ticksPerNs, (long long)run.sync.driftPpb);
+    printf("%-10s %12s %12s %12s %12s\n", "e2e", "min ns", "p50 ns", "p99 ns", "max ns");
+    clocksync_print("raw", run.raw, ticksPerNs);
+    clocksync_print("corrected", run.corrected, ticksPerNs);
+    if (0 != run.negative)
+    {
+        printf("%lld messages arrived before their corrected send time, %lld of them by more than rtt/2\n",
+               (long long)run.negative, (long long)run.beyondBound);
+    }
+
+    /* The estimate claims +/- rtt/2: only errors beyond that, or a shifted median, fail the run. */
+    int result = (0 != run.beyondBound);
+    if ((0u != run.raw->count) && (0u != run.corrected->count) &&
+        (MCF_hist_percentile(run.corrected, 50.0) > MCF_hist_percentile(run.raw, 50.0) + run.sync.rtt))
+    {
+        printf("corrected latencies exceed raw ones by more than the round trip (estimate error)\n");
+        result = 1;
+    }
+
+    pthread_barrier_destroy(&run.start);
+    MCF_bench_ring_free(&run.data);
+    MCF_bench_ring_free(&run.ping);
+    MCF_bench_ring_free(&run.pong);
+    free(run.stamps);
+    free(run.raw);
+    free(run.corrected);
+    return result;
+}
@@ -0,0 +1,313 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_ref_queues.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Round trips measured by the latency half of the comparison. */
+#define COMPARE_PINGPONG_MAX 200000u
+
+/**
+ * @brief Sequence checker filled by the consumer side of every queue.
+ */
+typedef struct
+{
+    uint32_t expected;
+    uint32_t errors;
+} compare_seq_t;
+
+/**
+ * @brief Uniform view of a queue, so every implementation runs the same workload.
+ *
+ * - `push`: Returns 0 when the queue is full.
+ * - `drain`: Consumes everything currently available, returns the number of messages.
+ */
+typedef struct
+{
+    const char *name;
+    void *(*create)(size_t capacity);
+    void (*destroy)(void *q);
+    int (*push)(void *q, uint32_t value);
+    uint32_t (*drain)(void *q, compare_seq_t *seq);
+} compare_queue_t;
+
+static inline void compare_check(compare_seq_t *seq, uint32_t value)
+{
+    if (value != seq->expected)
+    {
+        seq->errors++;
+    }
+    seq->expected = value + 1;
+}
+
+/*
+ * MCF adapter: MCF_receive() reports through the parser, which has no context
+ * argument, so the draining thread's state is passed in thread-local storage.
+ */
+static _Thread_local compare_seq_t *mcfSeq;
+static _Thread_local uint32_t mcfDrained;
+
+static void compare_mcf_parser(MCF_Message_t *msgBuf)
+{
+    compare_check(mcfSeq, msgBuf->u32);
+    mcfDrained++;
+}
+
+static void *compare_mcf_create(size_t capacity)
+{
+    MCF_bench_ring_t *ring = malloc(sizeof(*ring));
+
+    MCF_bench_ring_init(ring, 1, (uint16_t)(capacity + 1), compare_mcf_parser);
+    return ring;
+}
+
+static void compare_mcf_destroy(void *q)
+{
+    MCF_bench_ring_free(q);
+    free(q);
+}
+
+static int compare_mcf_push(void *q, uint32_t value)
+{
+    MCF_bench_ring_t *ring = q;
+
+    if (0 == MCF_bench_ring_free_space(&ring->tx))
+    {
+        return 0;
+    }
+    MCF_send_u32(&ring->tx, 1, value);
+    return 1;
+}
+
+static uint32_t compare_mcf_drain(void *q, compare_seq_t *seq)
+{
+    MCF_bench_ring_t *ring = q;
+
+    mcfSeq = seq;
+    mcfDrained = 0;
+    MCF_receive(&ring->rx);
+    return mcfDrained;
+}
+
+#define COMPARE_REF_ADAPTER(kind)                                                                                      \
+    static void *compare_##kind##_create(size_t capacity)                                                              \
+    {                                                                                                                  \
+        MCF_ref_##kind##_t *q = aligned_alloc(MCF_REF_CACHE_LINE, sizeof(*q));                                         \
+        MCF_ref_##kind##_init(q, capacity);                                                                            \
+        return q;                                                                                                      \
+    }                                                                                                                  \
+    static void compare_##kind##_destroy(void *q)                                                                      \
+    {                                                                                                                  \
+        MCF_ref_##kind##_free(q);                                                                                      \
+        free(q);                                                                                                       \
+    }                                                                                                                  \
+    static int compare_##kind##_push(void *q, uint32_t value)                                                          \
+    {                                                                                                                  \
+        return MCF_ref_##kind##_push(q, value);                                                                        \
+    }                                                                                                                  \
+    static uint32_t compare_##kind##_drain(void *q, compare_seq_t *seq)                                                \
+    {                                                                                                                  \
+        uint32_t count = 0;                                                                                            \
+        uint32_t value;                                                                                                \
+        while (MCF_ref_##kind##_pop(q, &value))                                                                        \
+        {                                                                                                              \
+            compare_check(seq, value);                                                                                 \
+            count++;                                                                                                   \
+        }                                                                                                              \
+        return count;                                                                                                  \
+    }
+
+COMPARE_REF_ADAPTER(lamport)
+COMPARE_REF_ADAPTER(rigtorp)
+COMPARE_REF_ADAPTER(vyukov)
+
+static const compare_queue_t compareQueues[] = {
+    {"MCF", compare_mcf_create, compare_mcf_destroy, compare_mcf_push, compare_mcf_drain},
+    {"lamport", compare_lamport_create, compare_lamport_destroy, compare_lamport_push, compare_lamport_drain},
+    {"rigtorp", compare_rigtorp_create, compare_rigtorp_destroy, compare_rigtorp_push, compare_rigtorp_drain},
+    {"vyukov", compare_vyukov_create, compare_vyukov_destroy, compare_vyukov_push, compare_vyukov_drain},
+};
+
+/**
+ * @brief State of one throughput or ping-pong run.
+ */
+typedef struct
+{
+    const compare_queue_t *impl;
+    void *forward;
+    void *backward;
+    uint32_t count;
+    pthread_barrier_t start;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint64_t *rttNs;
+    compare_seq_t seq;
+    compare_seq_t echoSeq;
+} compare_run_t;
+
+static void compare_push_wait(const compare_queue_t *impl, void *q, uint32_t value, uint32_t *spins)
+{
+    while (!impl->push(q, value))
+    {
+        MCF_bench_relax(spins);
+    }
+}
+
+static void *compare_stream_producer(void *arg)
+{
+    compare_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    run->startNs = MCF_bench_now_ns();
+
+    for (uint32_t seq = 0; seq < run->count; seq++)
+    {
+        compare_push_wait(run->impl, run->forward, seq, &spins);
+    }
+    return NULL;
+}
+
+static void *compare_stream_consumer(void *arg)
+{
+    compare_run_t *run = arg;
+    uint32_t spins = 0;
+    uint32_t received = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    while (received < run->count)
+    {
+        uint32_t drained = run->impl->drain(run->forward, &run->seq);
+
+        if (0 == drained)
+        {
+            MCF_bench_relax(&spins);
+        }
+        received += drained;
+    }
+    run->endNs = MCF_bench_now_ns();
+    return NULL;
+}
+
+static void *compare_ping(void *arg)
+{
+    compare_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+
+    for (uint32_t seq = 0; seq < run->count; seq++)
+    {
+        uint64_t sent = MCF_bench_now_ns();
+
+        compare_push_wait(run->impl, run->forward, seq, &spins);
+        while (0 == run->impl->drain(run->backward, &run->echoSeq))
+        {
+            MCF_bench_relax(&spins);
+        }
+        run->rttNs[seq] = MCF_bench_now_ns() - sent;
+    }
+    return NULL;
+}
+
+static void *compare_pong(void *arg)
+{
+    compare_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    for (uint32_t seq = 0; seq < run->count; seq++)
+    {
+        while (0 == run->impl->drain(run->forward, &run->seq))
+        {
+            MCF_bench_relax(&spins);
+        }
+        compare_push_wait(run->impl, run->backward, seq, &spins);
+    }
+    return NULL;
+}
+
+static void compare_run_threads(compare_run_t *run, void *(*first)(void *), void *(*second)(void *))
+{
+    pthread_t threads[2];
+
+    pthread_barrier_init(&run->start, NULL, 2);
+    pthread_create(&threads[0], NULL, second, run);
+    pthread_create(&threads[1], NULL, first, run);
+    pthread_join(threads[1], NULL);
+    pthread_join(threads[0], NULL);
+    pthread_barrier_destroy(&run->start);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+int MCF_bench_compare(void)
+{
+    size_t capacity = benchOptions.ringSize - 1u;
+    uint32_t pings = (benchOptions.messages < COMPARE_PINGPONG_MAX) ? benchOptions.messages : COMPARE_PINGPONG_MAX;
+    uint64_t *rtt = malloc(pings * sizeof(*rtt));
+    int result = 0;
+
+    printf("%-10s %12s %12s %12s %12s %12s\n", "queue", "ns/msg", "Mmsg/s", "rtt avg ns", "rtt p50 ns",
+           "rtt p99 ns");
+
+    for (size_t i = 0; i < sizeof(compareQueues) / sizeof(compareQueues[0]); i++)
+    {
+        const compare_queue_t *impl = &compareQueues[i];
+        compare_run_t stream = {.impl = impl, .count = benchOptions.messages};
+        compare_run_t pingpong = {.impl = impl, .count = pings, .rttNs = rtt};
+        uint64_t rttSum = 0;
+
+        stream.forward = impl->create(capacity);
+        compare_run_threads(&stream, compare_stream_producer, compare_stream_consumer);
+        impl->destroy(stream.forward);
+
+        pingpong.forward = impl->create(capacity);
+        pingpong.backward = impl->create(capacity);
+        compare_run_threads(&pingpong, compare_ping, compare_pong);
+        impl->destroy(pingpong.forward);
+        impl->destroy(pingpong.backward);
+
+        for (uint32_t p = 0; p < pings; p++)
+        {
+            rttSum += rtt[p];
+        }
+        qsort(rtt, pings, sizeof(*rtt), compare_u64);
+
+        double nsPerMsg = (double)(stream.endNs - stream.startNs) / (double)stream.count;
+        printf("%-10s %12.2f %12.2f %12.1f %12llu %12llu\n", impl->name, nsPerMsg, 1000.0 / nsPerMsg,
+               (double)rttSum / (double)pings, (unsigned long long)rtt[pings / 2],
+               (unsigned long long)rtt[(pings * 99u) / 100u]);
+
+        if ((0 != stream.seq.errors) || (0 != pingpong.seq.errors) || (0 != pingpong.echoSeq.errors))
+        {
+            fprintf(stderr, "%s: out-of-order messages detected\n", impl->name);
+            result = 1;
+        }
+    }
+
+    free(rtt);
+    return result;
+}
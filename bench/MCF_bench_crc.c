@@ -0,0 +1,243 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Cost of CRC32C-protected batches, and whether corruption is caught.
+ *
+ *     plain      MCF_send_batch() / MCF_receive()
+ *     crc        MCF_crc_send_batch() / MCF_crc_receive()
+ *     corrupt    as crc, but every CRC_CORRUPT_EVERY-th trailer is wrong
+ *
+ * The producer sends a counter in batches of CRC_BATCH. The consumer checks
+ * the sequence: only the batches with a wrong trailer may be missing, and
+ * exactly those must be reported as corrupt. First, every CRC32C
+ * implementation the CPU supports is checked and timed, and the one
+ * MCF_dispatch selected is named.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_crc.h"
+#include "MCF_dispatch.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CRC_BATCH 32u
+#define CRC_CORRUPT_EVERY 1024u
+#define CRC_KERNEL_BYTES 65536u
+#define CRC_KERNEL_ROUNDS 2000u
+
+typedef enum
+{
+    CRC_PLAIN = 0,
+    CRC_CHECKED,
+    CRC_CORRUPT,
+    CRC_VARIANT_COUNT
+} crc_variant_t;
+
+static const char *const crcVariantNames[CRC_VARIANT_COUNT] = {"plain", "crc", "corrupt"};
+
+typedef struct
+{
+    crc_variant_t variant;
+    uint32_t batches;
+    MCF_bench_ring_t ring;
+    MCF_CrcReceiver_t receiver;
+    pthread_barrier_t start;
+    volatile int producerDone;
+} crc_run_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t feature;
+    uint32_t (*crc32c)(uint32_t Crc, const void *Data, size_t Length);
+} crc_kernel_t;
+
+static const crc_kernel_t crcKernels[] = {
+    {"table", 0, MCF_crc32c_table},
+#if defined(MCF_CRC_HAVE_SSE42)
+    {"sse4.2", MCF_CPU_SSE4_2, MCF_crc32c_sse42},
+#endif
+#if defined(MCF_CRC_HAVE_ARMV8)
+    {"armv8", MCF_CPU_ARM_CRC32, MCF_crc32c_armv8},
+#endif
+};
+
+static uint32_t crcNext;
+static uint64_t crcGaps;
+static uint64_t crcErrors;
+
+static void crc_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 < crcNext)
+    {
+        crcErrors++;
+        return;
+    }
+    /* A rejected batch leaves a gap of exactly one batch. */
+    if (0u != (msgBuf->u32 - crcNext) % CRC_BATCH)
+    {
+        crcErrors++;
+    }
+    crcGaps += (msgBuf->u32 - crcNext) / CRC_BATCH;
+    crcNext = msgBuf->u32 + 1u;
+}
+
+static void *crc_producer(void *arg)
+{
+    crc_run_t *run = arg;
+    MCF_Message_t batch[CRC_BATCH];
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    for (uint32_t b = 0; b < run->batches; b++)
+    {
+        for (uint32_t i = 0; i < CRC_BATCH; i++)
+        {
+            batch[i] = (MCF_Message_t){.msgID = 1, .u32 = b * CRC_BATCH + i};
+        }
+        while (MCF_get_free(&run->ring.tx) < CRC_BATCH + 1u)
+        {
+            MCF_bench_relax(&spins);
+        }
+
+        if (CRC_PLAIN == run->variant)
+        {
+            (void)MCF_send_batch(&run->ring.tx, batch, CRC_BATCH);
+        }
+        else if ((CRC_CORRUPT == run->variant) && (CRC_CORRUPT_EVERY - 1u == b % CRC_CORRUPT_EVERY))
+        {
+            /* Same as a bit flipped in the ring between producer and consumer. */
+            MCF_Message_t trailer = {.msgID = MCF_CRC_TRAILER_ID,
+                                     .u32 = MCF_crc32c_messages(0, batch, CRC_BATCH) ^ 0x10u};
+            (void)MCF_send_batch(&run->ring.tx, batch, CRC_BATCH);
+            (void)MCF_send_batch(&run->ring.tx, &trailer, 1);
+        }
+        else
+        {
+            (void)MCF_crc_send_batch(&run->ring.tx, batch, CRC_BATCH);
+        }
+    }
+    run->producerDone = 1;
+    return NULL;
+}
+
+static void *crc_consumer(void *arg)
+{
+    crc_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+    for (;;)
+    {
+        int done = run->producerDone;
+
+        if (CRC_PLAIN == run->variant)
+        {
+            MCF_receive(&run->ring.rx);
+        }
+        else
+        {
+            (void)MCF_crc_receive(&run->receiver);
+        }
+        if (done && (0u == MCF_get_pending(&run->ring.rx)))
+        {
+            break;
+        }
+        MCF_bench_relax(&spins);
+    }
+    return NULL;
+}
+
+int MCF_bench_crc(void)
+{
+    static uint8_t kernelData[CRC_KERNEL_BYTES];
+    uint32_t batches = benchOptions.messages / CRC_BATCH;
+    uint32_t features = MCF_dispatch_detect();
+    int result = 0;
+
+    printf("CPU features:%s%s%s%s, dispatched CRC32C: %s\n", (features & MCF_CPU_SSE4_2) ? " sse4.2" : "",
+           (features & MCF_CPU_AVX2) ? " avx2" : "", (features & MCF_CPU_AVX512F) ? " avx512f" : "",
+           (features & MCF_CPU_ARM_CRC32) ? " arm-crc32" : "", MCF_crc32c_impl());
+    for (uint32_t i = 0; i < CRC_KERNEL_BYTES; i++)
+    {
+        kernelData[i] = (uint8_t)(i * 31u);
+    }
+    for (size_t k = 0; k < sizeof(crcKernels) / sizeof(crcKernels[0]); k++)
+    {
+        const crc_kernel_t *kernel = &crcKernels[k];
+        uint32_t crc = 0;
+
+        if (kernel->feature != (features & kernel->feature))
+        {
+            printf("  %-8s not supported by this CPU\n", kernel->name);
+            continue;
+        }
+        uint64_t startNs = MCF_bench_now_ns();
+        for (uint32_t r = 0; r < CRC_KERNEL_ROUNDS; r++)
+        {
+            crc = kernel->crc32c(crc, kernelData, CRC_KERNEL_BYTES);
+        }
+        uint64_t kernelNs = MCF_bench_now_ns() - startNs;
+        int valid = (0xE3069283u == kernel->crc32c(0, "123456789", 9));
+
+        printf("  %-8s %8.2f GB/s  crc %08X  %s\n", kernel->name,
+               (double)CRC_KERNEL_BYTES * CRC_KERNEL_ROUNDS / (double)kernelNs, crc,
+               valid ? "check value ok" : "check value MISMATCH");
+        result |= !valid;
+    }
+
+    printf("%u batches of %u messages\n", batches, CRC_BATCH);
+    printf("%-8s %10s %10s %10s %10s %10s %8s\n", "variant", "Mmsg/s", "ns/msg", "verified", "corrupt", "gaps",
+           "errors");
+    for (int variant = 0; variant < CRC_VARIANT_COUNT; variant++)
+    {
+        crc_run_t *run = calloc(1, sizeof(*run));
+        pthread_t producer;
+        pthread_t consumer;
+
+        run->variant = (crc_variant_t)variant;
+        run->batches = batches;
+        MCF_bench_ring_init(&run->ring, 1, benchOptions.ringSize, crc_parser);
+        MCF_crc_receiver_init(&run->receiver, &run->ring.rx);
+        pthread_barrier_init(&run->start, NULL, 2);
+        crcNext = 0;
+        crcGaps = 0;
+        crcErrors = 0;
+
+        uint64_t startNs = MCF_bench_now_ns();
+        pthread_create(&consumer, NULL, crc_consumer, run);
+        pthread_create(&producer, NULL, crc_producer, run);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+        uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+        uint32_t messages = batches * CRC_BATCH;
+        uint32_t expectedCorrupt = (CRC_CORRUPT == variant) ? batches / CRC_CORRUPT_EVERY : 0u;
+        /* A rejected final batch is a gap the parser never sees. */
+        crcGaps += (messages - crcNext) / CRC_BATCH;
+        uint64_t errors = crcErrors + (crcGaps != expectedCorrupt) + (run->receiver.corrupt != expectedCorrupt);
+
+        printf("%-8s %10.3f %10.2f %10u %10u %10llu %8llu\n", crcVariantNames[variant],
+               (double)messages * 1e3 / (double)elapsedNs, (double)elapsedNs / (double)messages,
+               run->receiver.batches, run->receiver.corrupt, (unsigned long long)crcGaps,
+               (unsigned long long)errors);
+        result |= (0u != errors);
+
+        pthread_barrier_destroy(&run->start);
+        MCF_bench_ring_free(&run->ring);
+        free(run);
+    }
+
+    return result;
+}
@@ -0,0 +1,177 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Report-by-exception on sensor-like traffic.
+ *
+ * Every sample period four f32 signals (slow sine plus noise) and four i16
+ * signals (ADC counts ramping slowly, +-1 count noise) are sent, either directly
+ * with MCF_send_*() or through MCF_deadband, and the ring is drained after each
+ * period. Single-threaded: the report shows the ring messages, the share that
+ * was suppressed and the producer plus consumer time per sample. The consumer
+ * keeps the last value per ID, which must never be further from the true signal
+ * than the deadband; this is checked after every sample period. A deterministic
+ * check first feeds NaN samples: changes to and from NaN are sent, repeated NaNs
+ * are suppressed.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_deadband.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEADBAND_SAMPLES 200000u
+#define DEADBAND_F32_SIGNALS 4u
+#define DEADBAND_I16_SIGNALS 4u
+#define DEADBAND_SIGNALS (DEADBAND_F32_SIGNALS + DEADBAND_I16_SIGNALS)
+#define DEADBAND_F32_BAND 0.01f
+#define DEADBAND_I16_BAND 2.0f
+
+/** Heartbeat interval, in sample periods. */
+#define DEADBAND_MAX_SILENCE 1000u
+
+static uint32_t deadbandSample;
+static MCF_Message_t deadbandSeen[DEADBAND_SIGNALS];
+
+static uint32_t deadband_now(void)
+{
+    return deadbandSample;
+}
+
+static void deadband_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->msgID < DEADBAND_SIGNALS)
+    {
+        deadbandSeen[msgBuf->msgID] = *msgBuf;
+    }
+}
+
+/** Cheap deterministic noise in [-1, 1]. */
+static float deadband_noise(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(int32_t)*state / 2147483648.0f;
+}
+
+/**
+ * @brief NaN handling on one f32 channel without heartbeat; returns the number of errors.
+ */
+static int deadband_check_nan(void)
+{
+    static const float samples[] = {1.0f, NAN, NAN, NAN, 1.0f, 1.0f, NAN};
+    static const int expected[] = {1, 1, 0, 0, 1, 0, 1};
+    MCF_bench_ring_t ring;
+    MCF_DeadbandEntry_t entry = {.msgID = 0, .absolute = DEADBAND_F32_BAND};
+    MCF_Deadband_t deadband;
+    int errors = 0;
+
+    MCF_bench_ring_init(&ring, 1, benchOptions.ringSize, deadband_parser);
+    MCF_deadband_init(&deadband, &ring.tx, &entry, 1, deadband_now);
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+        errors += (expected[i] != MCF_deadband_send_f32(&deadband, 0, samples[i]));
+        MCF_receive(&ring.rx);
+    }
+    MCF_bench_ring_free(&ring);
+    return errors;
+}
+
+int MCF_bench_deadband(void)
+{
+    int nanErrors = deadband_check_nan();
+    int result = (0 != nanErrors);
+
+    printf("NaN samples: %s\n", (0 == nanErrors) ? "ok" : "FAILED");
+
+    printf("%u samples x %u signals, bands f32 %.3f / i16 %.0f counts, heartbeat every %u samples\n",
+           DEADBAND_SAMPLES, DEADBAND_SIGNALS, (double)DEADBAND_F32_BAND, (double)DEADBAND_I16_BAND,
+           DEADBAND_MAX_SILENCE);
+    printf("%-10s %12s %12s %12s %12s\n", "producer", "messages", "suppressed", "ns/sample", "errors");
+
+    for (int filtered = 0; filtered < 2; filtered++)
+    {
+        MCF_bench_ring_t ring;
+        MCF_DeadbandEntry_t entries[DEADBAND_SIGNALS];
+        MCF_Deadband_t deadband;
+        uint32_t noiseState = 1u;
+        uint64_t errors = 0;
+
+        MCF_bench_ring_init(&ring, 1, benchOptions.ringSize, deadband_parser);
+        for (uint16_t i = 0; i < DEADBAND_SIGNALS; i++)
+        {
+            entries[i] = (MCF_DeadbandEntry_t){
+                .msgID = i,
+                .absolute = (i < DEADBAND_F32_SIGNALS) ? DEADBAND_F32_BAND : DEADBAND_I16_BAND,
+                .maxSilence = DEADBAND_MAX_SILENCE,
+            };
+            deadbandSeen[i] = (MCF_Message_t){.msgID = i};
+        }
+        MCF_deadband_init(&deadband, &ring.tx, entries, DEADBAND_SIGNALS, deadband_now);
+
+        uint64_t startNs = MCF_bench_now_ns();
+        for (deadbandSample = 0; deadbandSample < DEADBAND_SAMPLES; deadbandSample++)
+        {
+            float f32[DEADBAND_F32_SIGNALS];
+            int16_t i16[DEADBAND_I16_SIGNALS];
+
+            for (uint16_t i = 0; i < DEADBAND_F32_SIGNALS; i++)
+            {
+                f32[i] = sinf((float)deadbandSample * 1e-4f * (float)(i + 1u)) + 0.002f * deadband_noise(&noiseState);
+                if (filtered)
+                {
+                    MCF_deadband_send_f32(&deadband, i, f32[i]);
+                }
+                else
+                {
+                    MCF_send_f32(&ring.tx, i, f32[i]);
+                }
+            }
+            for (uint16_t i = 0; i < DEADBAND_I16_SIGNALS; i++)
+            {
+                uint16_t id = (uint16_t)(DEADBAND_F32_SIGNALS + i);
+
+                int32_t noise = (int32_t)(deadband_noise(&noiseState) * 1.5f);
+
+                i16[i] = (int16_t)((int32_t)(deadbandSample >> (8u + i)) + noise);
+                if (filtered)
+                {
+                    MCF_deadband_send_i16(&deadband, id, i16[i]);
+                }
+                else
+                {
+                    MCF_send_i16(&ring.tx, id, i16[i]);
+                }
+            }
+            MCF_receive(&ring.rx);
+
+            for (uint16_t i = 0; i < DEADBAND_F32_SIGNALS; i++)
+            {
+                errors += (fabsf(deadbandSeen[i].f32 - f32[i]) > DEADBAND_F32_BAND);
+            }
+            for (uint16_t i = 0; i < DEADBAND_I16_SIGNALS; i++)
+            {
+                errors += (fabsf((float)deadbandSeen[DEADBAND_F32_SIGNALS + i].i16 - (float)i16[i]) >
+                           DEADBAND_I16_BAND);
+            }
+        }
+        uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+        uint64_t messages = filtered ? deadband.passed : (uint64_t)DEADBAND_SAMPLES * DEADBAND_SIGNALS;
+        printf("%-10s %12llu %11.1f%% %12.1f %12llu\n", filtered ? "deadband" : "direct", (unsigned long long)messages,
+               100.0 * (double)(filtered ? deadband.suppressed : 0u) / ((double)DEADBAND_SAMPLES * DEADBAND_SIGNALS),
+               (double)elapsedNs / DEADBAND_SAMPLES, (unsigned long long)errors);
+        result |= (0u != errors);
+
+        MCF_bench_ring_free(&ring);
+    }
+
+    return result;
+}
@@ -0,0 +1,325 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Request/response over MCF_duplex against two independent MCF rings.
+ *
+ * The client keeps up to `window` requests outstanding, the server answers each
+ * one from its parser. With two rings both sides check the free space of their
+ * outgoing ring, i.e. read the other side's tail line, on every send; with the
+ * duplex channel consumed positions travel on the replies. Responses are checked
+ * to come back complete and in order.
+ *
+ * Deterministic checks run first: a piggybacked ack overtakes the published ack
+ * line, then the client fills its ring and must treat the stale line as old
+ * instead of overwriting unread slots; and request/response bursts that are all
+ * acknowledged by replies run past the 16-bit wrap of the ack counters, where a
+ * published line that is never refreshed would look new again.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_duplex.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const uint16_t duplexWindows[] = {1, 8, 32};
+
+typedef enum
+{
+    DUPLEX_CHANNEL = 0,
+    DUPLEX_TWO_RINGS,
+    DUPLEX_VARIANT_COUNT
+} duplex_variant_t;
+
+static const char *const duplexVariantNames[DUPLEX_VARIANT_COUNT] = {"mcf-duplex", "two-mcf-rings"};
+
+typedef struct
+{
+    duplex_variant_t variant;
+    uint16_t window;
+    MCF_Duplex_t client;
+    MCF_Duplex_t server;
+    MCF_bench_ring_t request;
+    MCF_bench_ring_t response;
+    pthread_barrier_t start;
+    volatile int done;
+} duplex_run_t;
+
+static duplex_run_t *duplexRun;
+static uint32_t duplexResponses;
+static uint64_t duplexErrors;
+
+static void duplex_client_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 != duplexResponses)
+    {
+        duplexErrors++;
+    }
+    duplexResponses++;
+}
+
+static void duplex_server_parser(MCF_Message_t *msgBuf)
+{
+    uint32_t spins = 0;
+
+    if (DUPLEX_CHANNEL == duplexRun->variant)
+    {
+        while (0 != MCF_duplex_send_u32(&duplexRun->server, msgBuf->msgID, msgBuf->u32))
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    else
+    {
+        while (0u == MCF_get_free(&duplexRun->response.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+        MCF_send_u32(&duplexRun->response.tx, msgBuf->msgID, msgBuf->u32);
+    }
+}
+
+static uint32_t duplexCheckReceived[8];
+static uint32_t duplexCheckCount;
+
+static void duplex_check_parser(MCF_Message_t *msgBuf)
+{
+    if (duplexCheckCount < sizeof(duplexCheckReceived) / sizeof(duplexCheckReceived[0]))
+    {
+        duplexCheckReceived[duplexCheckCount] = msgBuf->u32;
+    }
+    duplexCheckCount++;
+}
+
+/**
+ * @brief Stale published ack on a full ring (capacity 3); returns the number of errors.
+ */
+static int duplex_check_stale_ack(void)
+{
+    MCF_DuplexLink_t *links = aligned_alloc(MCF_CACHE_LINE_SIZE, 2u * sizeof(*links));
+    MCF_DuplexSlot_t slots[8] = {0};
+    MCF_Duplex_t a;
+    MCF_Duplex_t b;
+    int errors = 0;
+
+    MCF_duplex_init(&a, &links[0], &slots[0], 4, &links[1], &slots[4], 4, 3, duplex_check_parser);
+    MCF_duplex_init(&b, &links[1], &slots[4], 4, &links[0], &slots[0], 4, 3, duplex_check_parser);
+
+    /* B publishes 2 consumed, then piggybacks 3 on a reply that A reads. */
+    errors += (0 != MCF_duplex_send_u32(&a, 1, 0)) + (0 != MCF_duplex_send_u32(&a, 1, 1));
+    MCF_duplex_receive(&b);
+    MCF_duplex_flush_ack(&b);
+    errors += (0 != MCF_duplex_send_u32(&a, 1, 2));
+    MCF_duplex_receive(&b);
+    errors += (0 != MCF_duplex_send_u32(&b, 2, 100));
+    MCF_duplex_receive(&a);
+
+    /* A fills the ring; the published line (2) is now older than what A knows (3). */
+    for (uint32_t i = 3; i < 6; i++)
+    {
+        errors += (0 != MCF_duplex_send_u32(&a, 1, i));
+    }
+    errors += (0 == MCF_duplex_send_u32(&a, 1, 6));
+
+    duplexCheckCount = 0;
+    MCF_duplex_receive(&b);
+    errors += (3u != duplexCheckCount);
+    for (uint32_t i = 0; (i < 3u) && (i < duplexCheckCount); i++)
+    {
+        errors += (3u + i != duplexCheckReceived[i]);
+    }
+
+    free(links);
+    return errors;
+}
+
+static MCF_Duplex_t *duplexCheckReplier;
+static uint32_t duplexCheckNext;
+static int duplexCheckErrors;
+
+static void duplex_check_reply_parser(MCF_Message_t *msgBuf)
+{
+    duplexCheckErrors += (msgBuf->u32 != duplexCheckNext);
+    duplexCheckNext++;
+    duplexCheckErrors += (0 != MCF_duplex_send_u32(duplexCheckReplier, 2, msgBuf->u32));
+}
+
+/**
+ * @brief Full-ring bursts answered one reply per request, past two wraps of the
+ *        ack counters (capacity 3); returns the number of errors.
+ */
+static int duplex_check_ack_wrap(void)
+{
+    MCF_DuplexLink_t *links = aligned_alloc(MCF_CACHE_LINE_SIZE, 2u * sizeof(*links));
+    MCF_DuplexSlot_t slots[8] = {0};
+    MCF_Duplex_t a;
+    MCF_Duplex_t b;
+    uint32_t seq = 0;
+    int errors = 0;
+
+    MCF_duplex_init(&a, &links[0], &slots[0], 4, &links[1], &slots[4], 4, 3, duplex_check_parser);
+    MCF_duplex_init(&b, &links[1], &slots[4], 4, &links[0], &slots[0], 4, 3, duplex_check_reply_parser);
+    duplexCheckReplier = &b;
+    duplexCheckNext = 0;
+    duplexCheckErrors = 0;
+
+    /* Each burst ends with a send on a full ring, which reads the published line. */
+    for (uint32_t round = 0; (round < 2u * 65536u / 3u + 1u) && (0 == errors); round++)
+    {
+        uint32_t sent = 0;
+
+        while ((sent <= 3u) && (0 == MCF_duplex_send_u32(&a, 1, seq)))
+        {
+            seq++;
+            sent++;
+        }
+        duplexCheckCount = 0;
+        MCF_duplex_receive(&b);
+        MCF_duplex_receive(&a);
+        errors += (3u != sent) + (3u != duplexCheckCount) + duplexCheckErrors;
+    }
+
+    free(links);
+    return errors;
+}
+
+static void *duplex_server(void *arg)
+{
+    duplex_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+    while (!run->done)
+    {
+        if (DUPLEX_CHANNEL == run->variant)
+        {
+            MCF_duplex_receive(&run->server);
+        }
+        else
+        {
+            MCF_receive(&run->request.rx);
+        }
+        MCF_bench_relax(&spins);
+    }
+    return NULL;
+}
+
+static void *duplex_client(void *arg)
+{
+    duplex_run_t *run = arg;
+    uint32_t sent = 0;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    while (duplexResponses < benchOptions.messages)
+    {
+        while ((sent < benchOptions.messages) && ((sent - duplexResponses) < run->window))
+        {
+            if (DUPLEX_CHANNEL == run->variant)
+            {
+                if (0 != MCF_duplex_send_u32(&run->client, 1, sent))
+                {
+                    break;
+                }
+            }
+            else
+            {
+                if (0u == MCF_get_free(&run->request.tx))
+                {
+                    break;
+                }
+                MCF_send_u32(&run->request.tx, 1, sent);
+            }
+            sent++;
+        }
+
+        uint32_t before = duplexResponses;
+        if (DUPLEX_CHANNEL == run->variant)
+        {
+            MCF_duplex_receive(&run->client);
+        }
+        else
+        {
+            MCF_receive(&run->response.rx);
+        }
+        if (before == duplexResponses)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->done = 1;
+    return NULL;
+}
+
+int MCF_bench_duplex(void)
+{
+    uint16_t size = benchOptions.ringSize;
+    int checkErrors = duplex_check_stale_ack();
+    int wrapErrors = duplex_check_ack_wrap();
+    int result = (0 != checkErrors) || (0 != wrapErrors);
+
+    printf("stale ack on a full ring: %s\n", (0 == checkErrors) ? "ok" : "FAILED");
+    printf("published ack across counter wrap: %s\n", (0 == wrapErrors) ? "ok" : "FAILED");
+    printf("%-14s %7s %14s %8s\n", "channel", "window", "ns/round trip", "errors");
+
+    for (size_t w = 0; w < sizeof(duplexWindows) / sizeof(duplexWindows[0]); w++)
+    {
+        for (int variant = 0; variant < DUPLEX_VARIANT_COUNT; variant++)
+        {
+            duplex_run_t *run = calloc(1, sizeof(*run));
+            MCF_DuplexLink_t *links = aligned_alloc(MCF_CACHE_LINE_SIZE, 2u * sizeof(*links));
+            MCF_DuplexSlot_t *slots = calloc(2u * size, sizeof(*slots));
+            pthread_t client;
+            pthread_t server;
+
+            run->variant = (duplex_variant_t)variant;
+            run->window = duplexWindows[w];
+            if (run->window >= size)
+            {
+                run->window = (uint16_t)(size - 1u);
+            }
+
+            /* links[0]/slots[0..size): client to server, links[1]/slots[size..): server to client. */
+            MCF_duplex_init(&run->client, &links[0], &slots[0], size, &links[1], &slots[size], size,
+                            (uint16_t)(size / 2u), duplex_client_parser);
+            MCF_duplex_init(&run->server, &links[1], &slots[size], size, &links[0], &slots[0], size,
+                            (uint16_t)(size / 2u), duplex_server_parser);
+            MCF_bench_ring_init(&run->request, 1, size, duplex_server_parser);
+            MCF_bench_ring_init(&run->response, 1, size, duplex_client_parser);
+            pthread_barrier_init(&run->start, NULL, 2);
+            duplexRun = run;
+            duplexResponses = 0;
+            duplexErrors = 0;
+
+            uint64_t startNs = MCF_bench_now_ns();
+            pthread_create(&server, NULL, duplex_server, run);
+            pthread_create(&client, NULL, duplex_client, run);
+            pthread_join(client, NULL);
+            pthread_join(server, NULL);
+            uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+            printf("%-14s %7u %14.2f %8llu\n", duplexVariantNames[variant], run->window,
+                   (double)elapsedNs / (double)duplexResponses, (unsigned long long)duplexErrors);
+            result |= (0u != duplexErrors);
+
+            pthread_barrier_destroy(&run->start);
+            MCF_bench_ring_free(&run->request);
+            MCF_bench_ring_free(&run->response);
+            free(slots);
+            free(links);
+            free(run);
+        }
+    }
+
+    return result;
+}
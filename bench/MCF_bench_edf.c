@@ -0,0 +1,229 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * One overloaded consumer core serving three rings with different latency needs:
+ *
+ *     control    paced, 10 kmsg/s,  budget 100 us
+ *     telemetry  paced, 100 kmsg/s, budget 2 ms
+ *     bulk       unpaced (always backlogged), budget 100 ms
+ *
+ * Every message costs the consumer EDF_SERVICE_NS of work, so bulk alone can
+ * saturate it. The same load is run under MCF_edf and under plain round-robin
+ * MCF_receive() over the rings; the report shows each ring's latency and how
+ * many messages missed their budget.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include "MCF_edf.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Length of each policy run. */
+#define EDF_RUN_NS 1000000000ull
+
+/** Consumer work per message. */
+#define EDF_SERVICE_NS 2000u
+
+/** Messages per MCF_edf_run() call. */
+#define EDF_RUN_BATCH 64u
+
+typedef struct
+{
+    const char *name;
+    uint64_t periodNs;
+    uint32_t budgetNs;
+    uint16_t quantum;
+} edf_class_t;
+
+static const edf_class_t edfClasses[] = {
+    {"control", 100000u, 100000u, 1},
+    {"telemetry", 10000u, 2000000u, 8},
+    {"bulk", 0u, 100000000u, 32},
+};
+
+#define EDF_CLASS_COUNT (sizeof(edfClasses) / sizeof(edfClasses[0]))
+
+typedef enum
+{
+    EDF_POLICY_EDF = 0,
+    EDF_POLICY_ROUND_ROBIN,
+    EDF_POLICY_COUNT
+} edf_policy_t;
+
+static const char *const edfPolicyNames[EDF_POLICY_COUNT] = {"edf", "round-robin"};
+
+typedef struct
+{
+    edf_policy_t policy;
+    MCF_bench_ring_t rings[EDF_CLASS_COUNT];
+    uint32_t *stamps[EDF_CLASS_COUNT];
+    MCF_EdfRing_t edfRings[EDF_CLASS_COUNT];
+    MCF_Edf_t edf;
+    pthread_barrier_t start;
+    volatile int stop;
+} edf_run_t;
+
+typedef struct
+{
+    edf_run_t *run;
+    uint8_t index;
+} edf_producer_arg_t;
+
+static MCF_hist_t *edfLatency[EDF_CLASS_COUNT];
+static uint64_t edfMisses[EDF_CLASS_COUNT];
+
+static uint32_t edf_now(void)
+{
+    return (uint32_t)MCF_bench_now_ns();
+}
+
+static void edf_parser(MCF_Message_t *msgBuf)
+{
+    uint32_t waited = edf_now() - msgBuf->u32;
+    uint64_t workEnd = MCF_bench_now_ns() + EDF_SERVICE_NS;
+
+    MCF_hist_record(edfLatency[msgBuf->msgID], waited);
+    if (waited > edfClasses[msgBuf->msgID].budgetNs)
+    {
+        edfMisses[msgBuf->msgID]++;
+    }
+    while (MCF_bench_now_ns() < workEnd)
+    {
+    }
+}
+
+static void *edf_producer(void *arg)
+{
+    edf_producer_arg_t *producerArg = arg;
+    edf_run_t *run = producerArg->run;
+    const edf_class_t *class = &edfClasses[producerArg->index];
+    MCF_t *tx = &run->rings[producerArg->index].tx;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    uint64_t next = MCF_bench_now_ns();
+
+    while (!run->stop)
+    {
+        if ((0u != class->periodNs) && (MCF_bench_now_ns() < next))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+        if (0u == MCF_get_free(tx))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+
+        uint32_t now = edf_now();
+        MCF_edf_stamp(tx, run->stamps[producerArg->index], now);
+        MCF_send_u32(tx, producerArg->index, now);
+        next += class->periodNs;
+    }
+    return NULL;
+}
+
+static void *edf_consumer(void *arg)
+{
+    edf_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    uint64_t endNs = MCF_bench_now_ns() + EDF_RUN_NS;
+    while (MCF_bench_now_ns() < endNs)
+    {
+        uint16_t dispatched = 0;
+
+        if (EDF_POLICY_EDF == run->policy)
+        {
+            dispatched = MCF_edf_run(&run->edf, EDF_RUN_BATCH);
+        }
+        else
+        {
+            for (size_t i = 0; i < EDF_CLASS_COUNT; i++)
+            {
+                dispatched = (uint16_t)(dispatched + MCF_receive_n(&run->rings[i].rx, edfClasses[i].quantum));
+            }
+        }
+        if (0u == dispatched)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->stop = 1;
+    return NULL;
+}
+
+int MCF_bench_edf(void)
+{
+    printf("service %u ns/msg, %.1f s per policy\n", EDF_SERVICE_NS, (double)EDF_RUN_NS / 1e9);
+    printf("%-12s %-10s %10s %12s %12s %12s %10s\n", "policy", "ring", "messages", "p50 us", "p99 us", "max us",
+           "misses");
+
+    for (int policy = 0; policy < EDF_POLICY_COUNT; policy++)
+    {
+        edf_run_t *run = calloc(1, sizeof(*run));
+        edf_producer_arg_t args[EDF_CLASS_COUNT];
+        pthread_t producers[EDF_CLASS_COUNT];
+        pthread_t consumer;
+
+        run->policy = (edf_policy_t)policy;
+        for (size_t i = 0; i < EDF_CLASS_COUNT; i++)
+        {
+            MCF_bench_ring_init(&run->rings[i], 1, benchOptions.ringSize, edf_parser);
+            run->stamps[i] = calloc(benchOptions.ringSize, sizeof(uint32_t));
+            MCF_edf_ring_init(&run->edfRings[i], &run->rings[i].rx, run->stamps[i], edfClasses[i].budgetNs,
+                              edfClasses[i].quantum);
+            edfLatency[i] = malloc(sizeof(MCF_hist_t));
+            MCF_hist_reset(edfLatency[i]);
+            edfMisses[i] = 0;
+        }
+        MCF_edf_init(&run->edf, run->edfRings, EDF_CLASS_COUNT, edf_now);
+        pthread_barrier_init(&run->start, NULL, EDF_CLASS_COUNT + 1u);
+
+        pthread_create(&consumer, NULL, edf_consumer, run);
+        for (uint8_t i = 0; i < EDF_CLASS_COUNT; i++)
+        {
+            args[i].run = run;
+            args[i].index = i;
+            pthread_create(&producers[i], NULL, edf_producer, &args[i]);
+        }
+        pthread_join(consumer, NULL);
+        for (size_t i = 0; i < EDF_CLASS_COUNT; i++)
+        {
+            pthread_join(producers[i], NULL);
+        }
+
+        for (size_t i = 0; i < EDF_CLASS_COUNT; i++)
+        {
+            const MCF_hist_t *hist = edfLatency[i];
+
+            printf("%-12s %-10s %10llu %12.1f %12.1f %12.1f %10llu\n", edfPolicyNames[policy], edfClasses[i].name,
+                   (unsigned long long)hist->count, (double)MCF_hist_percentile(hist, 50.0) / 1e3,
+                   (double)MCF_hist_percentile(hist, 99.0) / 1e3, (double)hist->max / 1e3,
+                   (unsigned long long)edfMisses[i]);
+
+            MCF_bench_ring_free(&run->rings[i]);
+            free(run->stamps[i]);
+            free(edfLatency[i]);
+        }
+
+        pthread_barrier_destroy(&run->start);
+        free(run);
+    }
+
+    return 0;
+}
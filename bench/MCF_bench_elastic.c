@@ -0,0 +1,311 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Bursty load on an MCF_mpmc queue drained by a pool of consumer threads.
+ *
+ * The producer alternates ELASTIC_BURST_NS of sending every ELASTIC_BURST_GAP_NS
+ * with ELASTIC_IDLE_NS of silence; every message costs its consumer
+ * ELASTIC_SERVICE_NS, so one consumer cannot keep up with a burst. Pools of a
+ * fixed size are compared with an MCF_elastic pool that grows during bursts and
+ * parks consumers in between. The report shows latency, consumer time spent
+ * active and the scale events; every message must arrive exactly once.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include "MCF_elastic.h"
+#include "MCF_mpmc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ELASTIC_ORDER 10u
+#define ELASTIC_MAX_CONSUMERS 4u
+#define ELASTIC_CYCLES 4u
+#define ELASTIC_BURST_NS 100000000ull
+#define ELASTIC_IDLE_NS 150000000ull
+#define ELASTIC_BURST_GAP_NS 2000u
+#define ELASTIC_SERVICE_NS 5000u
+
+/** Supervisor sampling period and dwell times, in nanoseconds. */
+#define ELASTIC_POLL_NS 100000u
+#define ELASTIC_UP_DWELL_NS 1000000u
+#define ELASTIC_DOWN_DWELL_NS 10000000u
+
+/** Messages a consumer drains before checking whether it is still active. */
+#define ELASTIC_DRAIN_BATCH 16u
+
+typedef struct
+{
+    const char *name;
+    uint8_t minConsumers;
+    uint8_t maxConsumers;
+} elastic_variant_t;
+
+static const elastic_variant_t elasticVariants[] = {
+    {"static-1", 1, 1},
+    {"static-4", 4, 4},
+    {"elastic-1..4", 1, ELASTIC_MAX_CONSUMERS},
+};
+
+typedef struct
+{
+    MCF_Mpmc_t mpmc;
+    MCF_Elastic_t elastic;
+    MCF_hist_t *latency[ELASTIC_MAX_CONSUMERS];
+    uint64_t received[ELASTIC_MAX_CONSUMERS];
+    uint64_t sum[ELASTIC_MAX_CONSUMERS];
+    pthread_mutex_t parkLock;
+    pthread_cond_t parkCond;
+    pthread_barrier_t start;
+    uint64_t sent;
+    uint64_t sentSum;
+    uint64_t activeNs;
+    volatile int producerDone;
+    volatile int stop;
+} elastic_run_t;
+
+typedef struct
+{
+    elastic_run_t *run;
+    uint8_t index;
+} elastic_consumer_arg_t;
+
+static elastic_run_t *elasticRun;
+static _Thread_local uint8_t elasticConsumer;
+
+static uint32_t elastic_backlog(void)
+{
+    return MCF_mpmc_get_pending(&elasticRun->mpmc);
+}
+
+static uint32_t elastic_now(void)
+{
+    return (uint32_t)MCF_bench_now_ns();
+}
+
+static void elastic_on_scale(uint8_t active)
+{
+    (void)active;
+    pthread_mutex_lock(&elasticRun->parkLock);
+    pthread_cond_broadcast(&elasticRun->parkCond);
+    pthread_mutex_unlock(&elasticRun->parkLock);
+}
+
+static void elastic_parser(MCF_Message_t *msgBuf)
+{
+    uint64_t workEnd = MCF_bench_now_ns() + ELASTIC_SERVICE_NS;
+
+    MCF_hist_record(elasticRun->latency[elasticConsumer], (uint32_t)MCF_bench_now_ns() - msgBuf->u32);
+    elasticRun->received[elasticConsumer]++;
+    elasticRun->sum[elasticConsumer] += msgBuf->u32;
+    while (MCF_bench_now_ns() < workEnd)
+    {
+    }
+}
+
+static void *elastic_consumer(void *arg)
+{
+    elastic_consumer_arg_t *consumerArg = arg;
+    elastic_run_t *run = consumerArg->run;
+    uint32_t spins = 0;
+
+    elasticConsumer = consumerArg->index;
+    pthread_barrier_wait(&run->start);
+    while (!run->stop)
+    {
+        if (!MCF_elastic_is_active(&run->elastic, consumerArg->index))
+        {
+            pthread_mutex_lock(&run->parkLock);
+            while (!run->stop && !MCF_elastic_is_active(&run->elastic, consumerArg->index))
+            {
+                pthread_cond_wait(&run->parkCond, &run->parkLock);
+            }
+            pthread_mutex_unlock(&run->parkLock);
+            continue;
+        }
+        if (0u == MCF_mpmc_receive_n(&run->mpmc, ELASTIC_DRAIN_BATCH))
+        {
+            if (run->producerDone && (0u == MCF_mpmc_get_pending(&run->mpmc)))
+            {
+                break;
+            }
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void *elastic_producer(void *arg)
+{
+    elastic_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    for (uint32_t cycle = 0; cycle < ELASTIC_CYCLES; cycle++)
+    {
+        uint64_t burstEnd = MCF_bench_now_ns() + ELASTIC_BURST_NS;
+        uint64_t next = MCF_bench_now_ns();
+
+        while (next < burstEnd)
+        {
+            if (MCF_bench_now_ns() < next)
+            {
+                MCF_bench_relax(&spins);
+                continue;
+            }
+            /* The send time doubles as payload: count and sum prove exactly-once delivery. */
+            uint32_t stamp = (uint32_t)MCF_bench_now_ns();
+            if (0 != MCF_mpmc_send_u32(&run->mpmc, 1, stamp))
+            {
+                MCF_bench_relax(&spins);
+                continue;
+            }
+            run->sent++;
+            run->sentSum += stamp;
+            next += ELASTIC_BURST_GAP_NS;
+        }
+
+        uint64_t idleEnd = MCF_bench_now_ns() + ELASTIC_IDLE_NS;
+        while (MCF_bench_now_ns() < idleEnd)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->producerDone = 1;
+    return NULL;
+}
+
+static void *elastic_supervisor(void *arg)
+{
+    elastic_run_t *run = arg;
+    uint64_t next = MCF_bench_now_ns();
+    uint64_t last = next;
+
+    while (!run->stop)
+    {
+        uint64_t now = MCF_bench_now_ns();
+
+        if (now < next)
+        {
+            struct timespec pause = {0, (long)(next - now)};
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        run->activeNs += (now - last) * MCF_elastic_get_active(&run->elastic);
+        last = now;
+        MCF_elastic_poll(&run->elastic);
+        next += ELASTIC_POLL_NS;
+    }
+    return NULL;
+}
+
+int MCF_bench_elastic(void)
+{
+    int result = 0;
+
+    printf("%u bursts of %.0f ms at %u ns/msg, %.0f ms idle, service %u ns/msg\n", ELASTIC_CYCLES,
+           (double)ELASTIC_BURST_NS / 1e6, ELASTIC_BURST_GAP_NS, (double)ELASTIC_IDLE_NS / 1e6, ELASTIC_SERVICE_NS);
+    printf("%-14s %10s %10s %10s %10s %12s %5s %5s %5s %8s\n", "pool", "messages", "p50 us", "p99 us", "max us",
+           "consumer ms", "ups", "downs", "peak", "errors");
+
+    for (size_t v = 0; v < sizeof(elasticVariants) / sizeof(elasticVariants[0]); v++)
+    {
+        const elastic_variant_t *variant = &elasticVariants[v];
+        elastic_run_t *run = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*run));
+        _Atomic uint64_t *entries = calloc(MCF_MPMC_ENTRIES(ELASTIC_ORDER), sizeof(*entries));
+        MCF_Message_t *msgBuf = calloc(1u << ELASTIC_ORDER, sizeof(*msgBuf));
+        elastic_consumer_arg_t args[ELASTIC_MAX_CONSUMERS];
+        pthread_t consumers[ELASTIC_MAX_CONSUMERS];
+        pthread_t producer;
+        pthread_t supervisor;
+        MCF_ElasticConfig_t config = {
+            .getBacklog = elastic_backlog,
+            .getTime = elastic_now,
+            .onScale = elastic_on_scale,
+            .minConsumers = variant->minConsumers,
+            .maxConsumers = variant->maxConsumers,
+            .upBacklog = 64u,
+            .downBacklog = 4u,
+            .upDwell = ELASTIC_UP_DWELL_NS,
+            .downDwell = ELASTIC_DOWN_DWELL_NS,
+        };
+
+        memset(run, 0, sizeof(*run));
+        elasticRun = run;
+        MCF_mpmc_init(&run->mpmc, entries, msgBuf, ELASTIC_ORDER, elastic_parser);
+        MCF_elastic_init(&run->elastic, &config);
+        pthread_mutex_init(&run->parkLock, NULL);
+        pthread_cond_init(&run->parkCond, NULL);
+        pthread_barrier_init(&run->start, NULL, variant->maxConsumers + 1u);
+        for (uint8_t c = 0; c < variant->maxConsumers; c++)
+        {
+            run->latency[c] = malloc(sizeof(MCF_hist_t));
+            MCF_hist_reset(run->latency[c]);
+            args[c].run = run;
+            args[c].index = c;
+            pthread_create(&consumers[c], NULL, elastic_consumer, &args[c]);
+        }
+        pthread_create(&producer, NULL, elastic_producer, run);
+        pthread_create(&supervisor, NULL, elastic_supervisor, run);
+
+        pthread_join(producer, NULL);
+        while (0u != MCF_mpmc_get_pending(&run->mpmc))
+        {
+            struct timespec pause = {0, 1000000};
+            nanosleep(&pause, NULL);
+        }
+        pthread_mutex_lock(&run->parkLock);
+        run->stop = 1;
+        pthread_cond_broadcast(&run->parkCond);
+        pthread_mutex_unlock(&run->parkLock);
+        for (uint8_t c = 0; c < variant->maxConsumers; c++)
+        {
+            pthread_join(consumers[c], NULL);
+        }
+        pthread_join(supervisor, NULL);
+
+        uint64_t received = 0;
+        uint64_t sum = 0;
+        for (uint8_t c = 0; c < variant->maxConsumers; c++)
+        {
+            received += run->received[c];
+            sum += run->sum[c];
+            if (0u != c)
+            {
+                MCF_hist_merge(run->latency[0], run->latency[c]);
+                free(run->latency[c]);
+            }
+        }
+        uint64_t errors = (received != run->sent) + (sum != run->sentSum);
+        const MCF_hist_t *hist = run->latency[0];
+
+        printf("%-14s %10llu %10.1f %10.1f %10.1f %12llu %5u %5u %5u %8llu\n", variant->name,
+               (unsigned long long)received, (double)MCF_hist_percentile(hist, 50.0) / 1e3,
+               (double)MCF_hist_percentile(hist, 99.0) / 1e3, (double)hist->max / 1e3,
+               (unsigned long long)(run->activeNs / 1000000u), run->elastic.metrics.scaleUps,
+               run->elastic.metrics.scaleDowns, run->elastic.metrics.peakConsumers, (unsigned long long)errors);
+        result |= (0u != errors);
+
+        free(run->latency[0]);
+        pthread_barrier_destroy(&run->start);
+        pthread_cond_destroy(&run->parkCond);
+        pthread_mutex_destroy(&run->parkLock);
+        free(msgBuf);
+        free(entries);
+        free(run);
+    }
+
+    return result;
+}
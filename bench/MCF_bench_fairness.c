@@ -0,0 +1,209 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * One chatty producer against four quiet ones on a single MCF_mpsc channel.
+ *
+ * The chatty producer sends as fast as its lane accepts, the quiet producers are
+ * paced at FAIR_QUIET_PERIOD_NS each. Every message costs the consumer
+ * FAIR_SERVICE_NS of work, so the chatty lane alone saturates it. The same load
+ * is run with every merge policy; the report shows each class's share of the
+ * consumer and the latency of its messages, and checks per-lane ordering.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include "MCF_mpsc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Length of each policy run. */
+#define FAIR_RUN_NS 1000000000ull
+
+/** Consumer work per message. */
+#define FAIR_SERVICE_NS 1000u
+
+/** Send period of every quiet producer. */
+#define FAIR_QUIET_PERIOD_NS 50000u
+
+/** Producers on the channel, producer 0 is the chatty one. */
+#define FAIR_PRODUCERS 5u
+
+static const MCF_MpscMerge_t fairMerges[] = {MCF_MPSC_ROUND_ROBIN, MCF_MPSC_READY_BITMAP,
+                                             MCF_MPSC_DEFICIT_ROUND_ROBIN};
+static const char *const fairMergeNames[] = {"round-robin", "ready-bitmap", "deficit-rr"};
+
+#define FAIR_MERGE_COUNT (sizeof(fairMerges) / sizeof(fairMerges[0]))
+
+typedef struct
+{
+    MCF_Mpsc_t *mpsc;
+    pthread_barrier_t start;
+    volatile int stop;
+} fair_run_t;
+
+typedef struct
+{
+    fair_run_t *run;
+    uint8_t index;
+} fair_producer_arg_t;
+
+/* Indexed by lane; producers register in any order. */
+static uint8_t fairChatty[FAIR_PRODUCERS];
+static uint32_t fairLastSent[FAIR_PRODUCERS];
+static uint64_t fairReceived[FAIR_PRODUCERS];
+static uint64_t fairErrors;
+static MCF_hist_t *fairLatency[2];
+
+static void fair_parser(MCF_Message_t *msgBuf)
+{
+    uint8_t lane = (uint8_t)msgBuf->msgID;
+    uint32_t sentNs = msgBuf->u32;
+    uint64_t workEnd = MCF_bench_now_ns() + FAIR_SERVICE_NS;
+
+    MCF_hist_record(fairLatency[fairChatty[lane]], (uint32_t)MCF_bench_now_ns() - sentNs);
+    /* Send stamps of one lane never go backwards. */
+    if ((0u != fairReceived[lane]) && (0 > (int32_t)(sentNs - fairLastSent[lane])))
+    {
+        fairErrors++;
+    }
+    fairLastSent[lane] = sentNs;
+    fairReceived[lane]++;
+
+    while (MCF_bench_now_ns() < workEnd)
+    {
+    }
+}
+
+static void *fair_producer(void *arg)
+{
+    fair_producer_arg_t *producerArg = arg;
+    fair_run_t *run = producerArg->run;
+    uint64_t periodNs = (0u == producerArg->index) ? 0u : FAIR_QUIET_PERIOD_NS;
+    int lane = MCF_mpsc_register(run->mpsc);
+    uint32_t spins = 0;
+
+    fairChatty[lane] = (0u == producerArg->index);
+    pthread_barrier_wait(&run->start);
+    uint64_t next = MCF_bench_now_ns();
+
+    while (!run->stop)
+    {
+        if ((0u != periodNs) && (MCF_bench_now_ns() < next))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+        if (0 != MCF_mpsc_send_u32(run->mpsc, (uint8_t)lane, (uint16_t)lane, (uint32_t)MCF_bench_now_ns()))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+        next += periodNs;
+    }
+    return NULL;
+}
+
+static void *fair_consumer(void *arg)
+{
+    fair_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    uint64_t endNs = MCF_bench_now_ns() + FAIR_RUN_NS;
+    while (MCF_bench_now_ns() < endNs)
+    {
+        uint64_t before = fairLatency[0]->count + fairLatency[1]->count;
+
+        MCF_mpsc_receive(run->mpsc);
+        if (before == fairLatency[0]->count + fairLatency[1]->count)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->stop = 1;
+    return NULL;
+}
+
+int MCF_bench_fairness(void)
+{
+    static const char *const classNames[2] = {"quiet", "chatty"};
+    int result = 0;
+
+    printf("service %u ns/msg, quiet period %u ns, %.1f s per merge\n", FAIR_SERVICE_NS, FAIR_QUIET_PERIOD_NS,
+           (double)FAIR_RUN_NS / 1e9);
+    printf("%-14s %-8s %10s %8s %12s %12s %12s %8s\n", "merge", "class", "messages", "share", "p50 us", "p99 us",
+           "max us", "errors");
+
+    for (size_t m = 0; m < FAIR_MERGE_COUNT; m++)
+    {
+        fair_run_t *run = calloc(1, sizeof(*run));
+        MCF_Mpsc_t *mpsc = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*mpsc));
+        MCF_t *lanes = calloc(FAIR_PRODUCERS, sizeof(*lanes));
+        MCF_Indices_t *indices = aligned_alloc(MCF_CACHE_LINE_SIZE, FAIR_PRODUCERS * sizeof(*indices));
+        MCF_Message_t *msgBufs = calloc((size_t)FAIR_PRODUCERS * benchOptions.ringSize, sizeof(*msgBufs));
+        fair_producer_arg_t args[FAIR_PRODUCERS];
+        pthread_t producers[FAIR_PRODUCERS];
+        pthread_t consumer;
+
+        MCF_mpsc_init(mpsc, lanes, indices, msgBufs, FAIR_PRODUCERS, benchOptions.ringSize, fair_parser,
+                      fairMerges[m]);
+        run->mpsc = mpsc;
+        for (size_t c = 0; c < 2u; c++)
+        {
+            fairLatency[c] = malloc(sizeof(MCF_hist_t));
+            MCF_hist_reset(fairLatency[c]);
+        }
+        for (size_t p = 0; p < FAIR_PRODUCERS; p++)
+        {
+            fairReceived[p] = 0;
+        }
+        fairErrors = 0;
+        pthread_barrier_init(&run->start, NULL, FAIR_PRODUCERS + 1u);
+
+        pthread_create(&consumer, NULL, fair_consumer, run);
+        for (uint8_t p = 0; p < FAIR_PRODUCERS; p++)
+        {
+            args[p].run = run;
+            args[p].index = p;
+            pthread_create(&producers[p], NULL, fair_producer, &args[p]);
+        }
+        pthread_join(consumer, NULL);
+        for (size_t p = 0; p < FAIR_PRODUCERS; p++)
+        {
+            pthread_join(producers[p], NULL);
+        }
+
+        uint64_t total = fairLatency[0]->count + fairLatency[1]->count;
+        for (size_t c = 0; c < 2u; c++)
+        {
+            const MCF_hist_t *hist = fairLatency[c];
+
+            printf("%-14s %-8s %10llu %7.1f%% %12.1f %12.1f %12.1f %8llu\n", fairMergeNames[m], classNames[c],
+                   (unsigned long long)hist->count, (0u != total) ? 100.0 * (double)hist->count / (double)total : 0.0,
+                   (double)MCF_hist_percentile(hist, 50.0) / 1e3, (double)MCF_hist_percentile(hist, 99.0) / 1e3,
+                   (double)hist->max / 1e3, (unsigned long long)fairErrors);
+            free(fairLatency[c]);
+        }
+        result |= (0u != fairErrors);
+
+        pthread_barrier_destroy(&run->start);
+        free(msgBufs);
+        free(indices);
+        free(lanes);
+        free(mpsc);
+        free(run);
+    }
+
+    return result;
+}
@@ -0,0 +1,214 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Consumer cost with many producers: a flat tree (the consumer polls every
+ * producer ring) against MCF_fanin trees with combiner threads, one per node.
+ *
+ * The figure of merit is the consumer's CPU time per message, which should stay
+ * flat as producers are added when combiners batch for it. Per-producer order
+ * is checked through the whole tree.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_fanin.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const uint16_t faninProducerCounts[] = {16, 64, 256};
+
+/** Fan-out of the trees; 0 stands for flat (fan-out = producers). */
+static const uint16_t faninFanouts[] = {0, 16, 8};
+
+typedef struct
+{
+    MCF_Fanin_t tree;
+    uint32_t perProducer;
+    pthread_barrier_t start;
+    volatile int done;
+    _Atomic uint64_t fullRetries;
+} fanin_run_t;
+
+typedef struct
+{
+    fanin_run_t *run;
+    uint16_t index;
+} fanin_thread_arg_t;
+
+static uint32_t *faninExpected;
+static uint64_t faninReceived;
+static uint64_t faninErrors;
+
+static void fanin_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 != faninExpected[msgBuf->msgID])
+    {
+        faninErrors++;
+    }
+    faninExpected[msgBuf->msgID] = msgBuf->u32 + 1u;
+    faninReceived++;
+}
+
+static void *fanin_producer(void *arg)
+{
+    fanin_thread_arg_t *threadArg = arg;
+    MCF_t *leaf = MCF_fanin_producer(&threadArg->run->tree, threadArg->index);
+    uint64_t retries = 0;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&threadArg->run->start);
+    for (uint32_t seq = 0; seq < threadArg->run->perProducer; seq++)
+    {
+        MCF_Message_t msg = {.msgID = threadArg->index, .u32 = seq};
+
+        while (0u == MCF_send_batch(leaf, &msg, 1))
+        {
+            retries++;
+            MCF_bench_relax(&spins);
+        }
+    }
+    atomic_fetch_add(&threadArg->run->fullRetries, retries);
+    return NULL;
+}
+
+static void *fanin_combiner(void *arg)
+{
+    fanin_thread_arg_t *threadArg = arg;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&threadArg->run->start);
+    while (!threadArg->run->done)
+    {
+        if (0u == MCF_fanin_combine(&threadArg->run->tree, threadArg->index))
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+static uint64_t fanin_thread_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+static void *fanin_consumer(void *arg)
+{
+    fanin_run_t *run = arg;
+    uint64_t total = (uint64_t)run->perProducer * run->tree.producers;
+    uint32_t spins = 0;
+    uint64_t *cpuNs = malloc(sizeof(*cpuNs));
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    uint64_t startNs = fanin_thread_cpu_ns();
+    while (faninReceived < total)
+    {
+        uint64_t before = faninReceived;
+
+        MCF_fanin_receive(&run->tree);
+        if (before == faninReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    *cpuNs = fanin_thread_cpu_ns() - startNs;
+    run->done = 1;
+    return cpuNs;
+}
+
+int MCF_bench_fanin(void)
+{
+    int result = 0;
+
+    printf("%9s %7s %6s %7s %12s %14s %14s %8s\n", "producers", "fanout", "nodes", "levels", "ns/msg",
+           "consumer cpu", "full retries", "errors");
+
+    for (size_t p = 0; p < sizeof(faninProducerCounts) / sizeof(faninProducerCounts[0]); p++)
+    {
+        for (size_t f = 0; f < sizeof(faninFanouts) / sizeof(faninFanouts[0]); f++)
+        {
+            uint16_t producers = faninProducerCounts[p];
+            uint16_t fanout = (0u != faninFanouts[f]) ? faninFanouts[f] : producers;
+
+            if ((0u != faninFanouts[f]) && (fanout >= producers))
+            {
+                /* Same as the flat run. */
+                continue;
+            }
+
+            uint16_t nodes = MCF_fanin_node_count(producers, fanout);
+            uint16_t leafSize = benchOptions.ringSize;
+            uint16_t nodeSize = (uint16_t)((4u * leafSize < UINT16_MAX) ? 4u * leafSize : UINT16_MAX);
+            size_t rings = (size_t)producers + nodes;
+            fanin_run_t *run = malloc(sizeof(*run));
+            MCF_t *handles = calloc(rings, sizeof(*handles));
+            MCF_Indices_t *indices = aligned_alloc(MCF_CACHE_LINE_SIZE, rings * sizeof(*indices));
+            MCF_Message_t *msgBufs = calloc(((size_t)producers * leafSize) + ((size_t)nodes * nodeSize),
+                                             sizeof(MCF_Message_t));
+            pthread_t *threads = calloc(rings, sizeof(*threads));
+            fanin_thread_arg_t *args = calloc(rings, sizeof(*args));
+            pthread_t consumer;
+            uint64_t *cpuNs;
+
+            *run = (fanin_run_t){.perProducer = benchOptions.messages / producers};
+            MCF_fanin_init(&run->tree, handles, indices, msgBufs, producers, fanout, leafSize, nodeSize, fanin_parser);
+            pthread_barrier_init(&run->start, NULL, (unsigned)rings + 1u);
+            faninExpected = calloc(producers, sizeof(*faninExpected));
+            faninReceived = 0;
+            faninErrors = 0;
+
+            uint64_t startNs = MCF_bench_now_ns();
+            pthread_create(&consumer, NULL, fanin_consumer, run);
+            for (size_t i = 0; i < rings; i++)
+            {
+                args[i].run = run;
+                args[i].index = (uint16_t)((i < producers) ? i : (i - producers));
+                pthread_create(&threads[i], NULL, (i < producers) ? fanin_producer : fanin_combiner, &args[i]);
+            }
+            pthread_join(consumer, (void **)&cpuNs);
+            for (size_t i = 0; i < rings; i++)
+            {
+                pthread_join(threads[i], NULL);
+            }
+            uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+            for (uint16_t i = 0; i < producers; i++)
+            {
+                faninErrors += (run->perProducer != faninExpected[i]);
+            }
+
+            printf("%9u %7u %6u %7u %12.2f %14.2f %14llu %8llu\n", producers, fanout, nodes, run->tree.levels,
+                   (double)elapsedNs / (double)faninReceived, (double)*cpuNs / (double)faninReceived,
+                   (unsigned long long)atomic_load(&run->fullRetries), (unsigned long long)faninErrors);
+            result |= (0u != faninErrors);
+
+            pthread_barrier_destroy(&run->start);
+            free(cpuNs);
+            free(faninExpected);
+            free(args);
+            free(threads);
+            free(msgBufs);
+            free(indices);
+            free(handles);
+            free(run);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,130 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_bench_hist.h"
+#include <math.h>
+#include <string.h>
+
+#define HIST_SUB_COUNT (1u << MCF_HIST_PRECISION_BITS)
+#define HIST_HALF_COUNT (1u << (MCF_HIST_PRECISION_BITS - 1u))
+
+/*
+ * Values below HIST_SUB_COUNT get one bucket each. Above that every power of two
+ * is split into HIST_HALF_COUNT linear buckets, indexed by the value shifted down
+ * to its top MCF_HIST_PRECISION_BITS bits.
+ */
+static uint32_t hist_index(uint64_t value)
+{
+    if (value < HIST_SUB_COUNT)
+    {
+        return (uint32_t)value;
+    }
+
+    uint32_t shift = (uint32_t)(63 - __builtin_clzll(value)) - MCF_HIST_PRECISION_BITS + 1u;
+    return (shift * HIST_HALF_COUNT) + (uint32_t)(value >> shift);
+}
+
+static uint64_t hist_highest_value(uint32_t index)
+{
+    if (index < HIST_SUB_COUNT)
+    {
+        return index;
+    }
+
+    uint32_t shift = (index / HIST_HALF_COUNT) - 1u;
+    uint64_t sub = index - (shift * HIST_HALF_COUNT);
+    return (sub << shift) + ((1ull << shift) - 1u);
+}
+
+void MCF_hist_reset(MCF_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+void MCF_hist_record(MCF_hist_t *hist, uint64_t value)
+{
+    hist->bucket[hist_index(value)]++;
+    hist->count++;
+    hist->sum += (double)value;
+    hist->sumSquares += (double)value * (double)value;
+    if (value < hist->min)
+    {
+        hist->min = value;
+    }
+    if (value > hist->max)
+    {
+        hist->max = value;
+    }
+}
+
+void MCF_hist_merge(MCF_hist_t *dst, const MCF_hist_t *src)
+{
+    for (uint32_t i = 0; i < MCF_HIST_BUCKETS; i++)
+    {
+        dst->bucket[i] += src->bucket[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    dst->sumSquares += src->sumSquares;
+    if (src->min < dst->min)
+    {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max)
+    {
+        dst->max = src->max;
+    }
+}
+
+uint64_t MCF_hist_percentile(const MCF_hist_t *hist, double percentile)
+{
+    uint64_t rank;
+    uint64_t seen = 0;
+
+    if (0 == hist->count)
+    {
+        return 0;
+    }
+
+    rank = (uint64_t)ceil((percentile / 100.0) * (double)hist->count);
+    if (0 == rank)
+    {
+        rank = 1;
+    }
+
+    for (uint32_t i = 0; i < MCF_HIST_BUCKETS; i++)
+    {
+        seen += hist->bucket[i];
+        if (seen >= rank)
+        {
+            uint64_t value = hist_highest_value(i);
+            return (value < hist->max) ? value : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+double MCF_hist_mean(const MCF_hist_t *hist)
+{
+    return (0 != hist->count) ? (hist->sum / (double)hist->count) : 0.0;
+}
+
+double MCF_hist_stddev(const MCF_hist_t *hist)
+{
+    if (2 > hist->count)
+    {
+        return 0.0;
+    }
+
+    double mean = MCF_hist_mean(hist);
+    double variance = (hist->sumSquares / (double)hist->count) - (mean * mean);
+    return (0.0 < variance) ? sqrt(variance) : 0.0;
+}
@@ -0,0 +1,72 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_BENCH_HIST_H_
+#define MULTICORE_FIFO_MCF_BENCH_HIST_H_
+
+#include <stdint.h>
+
+/** Sub-bucket precision: values are kept with 2^-(bits-1) relative error (under 1% for 8). */
+#define MCF_HIST_PRECISION_BITS 8u
+
+/** Buckets covering the whole 64-bit range at the configured precision. */
+#define MCF_HIST_BUCKETS ((66u - MCF_HIST_PRECISION_BITS) << (MCF_HIST_PRECISION_BITS - 1u))
+
+/**
+ * @brief HDR-style log-linear histogram of 64-bit values (ticks or nanoseconds).
+ *
+ * Recording is constant time and allocation free, so it can be called from the
+ * measured loop. Exact minimum, maximum, mean and standard deviation are tracked
+ * next to the buckets.
+ */
+typedef struct
+{
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+    double sumSquares;
+    uint64_t bucket[MCF_HIST_BUCKETS];
+} MCF_hist_t;
+
+/**
+ * @brief Clears the histogram.
+ */
+void MCF_hist_reset(MCF_hist_t *hist);
+
+/**
+ * @brief Records one value.
+ */
+void MCF_hist_record(MCF_hist_t *hist, uint64_t value);
+
+/**
+ * @brief Adds all values recorded in `src` to `dst`.
+ */
+void MCF_hist_merge(MCF_hist_t *dst, const MCF_hist_t *src);
+
+/**
+ * @brief Returns the value below or at which `percentile` percent of the records fall.
+ *
+ * The result is the highest value equivalent to the matching bucket, so it never
+ * under-reports a tail.
+ */
+uint64_t MCF_hist_percentile(const MCF_hist_t *hist, double percentile);
+
+/**
+ * @brief Returns the mean of the recorded values.
+ */
+double MCF_hist_mean(const MCF_hist_t *hist);
+
+/**
+ * @brief Returns the standard deviation of the recorded values (jitter).
+ */
+double MCF_hist_stddev(const MCF_hist_t *hist);
+
+#endif /* MULTICORE_FIFO_MCF_BENCH_HIST_H_ */
@@ -0,0 +1,295 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Deterministic single-threaded benchmark of the send and receive paths.
+ *
+ * Every scenario runs a fixed workload from a freshly initialized ring, so the
+ * instruction count per message only changes when the code does. Counts come from
+ * perf counters; when the binary is built with valgrind headers available, each
+ * scenario is also dumped as a separate callgrind/cachegrind record:
+ *
+ *     valgrind --tool=callgrind --instr-atstart=no ./mcf_bench icount
+ *
+ * With --save-baseline the results are written to a file, and with --baseline a
+ * later run is compared against it and fails when a scenario regressed by more
+ * than --threshold percent.
+ */
+
+#include "MCF_bench.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__has_include)
+#if __has_include(<valgrind/callgrind.h>)
+#include <valgrind/callgrind.h>
+#define ICOUNT_BEGIN(name) CALLGRIND_START_INSTRUMENTATION
+#define ICOUNT_END(name)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        CALLGRIND_DUMP_STATS_AT(name);                                                                                 \
+        CALLGRIND_STOP_INSTRUMENTATION;                                                                                \
+    } while (0)
+#elif __has_include(<valgrind/cachegrind.h>)
+#include <valgrind/cachegrind.h>
+#define ICOUNT_BEGIN(name) CACHEGRIND_START_INSTRUMENTATION
+#define ICOUNT_END(name) CACHEGRIND_STOP_INSTRUMENTATION
+#endif
+#endif
+
+#ifndef ICOUNT_BEGIN
+#define ICOUNT_BEGIN(name) ((void)(name))
+#define ICOUNT_END(name) ((void)(name))
+#endif
+
+/** Rounds of each scenario; the ring starts from index 0 in every scenario. */
+#define ICOUNT_ROUNDS 1000u
+
+/** Maximum number of scenarios kept in a baseline file. */
+#define ICOUNT_MAX_BASELINE 32
+
+typedef struct
+{
+    char name[32];
+    double instructions;
+    double cycles;
+} icount_result_t;
+
+static uint32_t icountReceived;
+
+static void icount_parser(MCF_Message_t *msgBuf)
+{
+    icountReceived += msgBuf->msgID;
+}
+
+static void icount_fill(MCF_bench_ring_t *ring, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        MCF_send_u32(&ring->tx, 1, i);
+    }
+}
+
+/** Sends a full ring per round, counting only the sends. */
+static uint64_t icount_send(MCF_bench_ring_t *ring, MCF_perf_t *perf)
+{
+    uint16_t batch = benchOptions.ringSize - 1u;
+
+    for (uint32_t round = 0; round < ICOUNT_ROUNDS; round++)
+    {
+        MCF_perf_start(perf);
+        for (uint16_t i = 0; i < batch; i++)
+        {
+            MCF_send_f32(&ring->tx, 1, (float)i);
+        }
+        MCF_perf_stop(perf);
+        MCF_receive(&ring->rx);
+    }
+    return (uint64_t)ICOUNT_ROUNDS * batch;
+}
+
+/** Drains a full ring per round, counting only the receive. */
+static uint64_t icount_receive(MCF_bench_ring_t *ring, MCF_perf_t *perf)
+{
+    uint16_t batch = benchOptions.ringSize - 1u;
+
+    for (uint32_t round = 0; round < ICOUNT_ROUNDS; round++)
+    {
+        icount_fill(ring, batch);
+        MCF_perf_start(perf);
+        MCF_receive(&ring->rx);
+        MCF_perf_stop(perf);
+    }
+    return (uint64_t)ICOUNT_ROUNDS * batch;
+}
+
+/** One send followed by one receive, the pattern of a lightly loaded link. */
+static uint64_t icount_pingpong(MCF_bench_ring_t *ring, MCF_perf_t *perf)
+{
+    uint32_t messages = (uint32_t)ICOUNT_ROUNDS * benchOptions.ringSize;
+
+    MCF_perf_start(perf);
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        MCF_send_u32(&ring->tx, 1, i);
+        MCF_receive(&ring->rx);
+    }
+    MCF_perf_stop(perf);
+    return messages;
+}
+
+static const struct
+{
+    const char *name;
+    uint64_t (*run)(MCF_bench_ring_t *ring, MCF_perf_t *perf);
+} icountScenarios[] = {
+    {"send", icount_send},
+    {"receive", icount_receive},
+    {"send+receive", icount_pingpong},
+};
+
+#define ICOUNT_SCENARIO_COUNT (sizeof(icountScenarios) / sizeof(icountScenarios[0]))
+
+static int icount_load_baseline(const char *path, icount_result_t *baseline, int *count)
+{
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open baseline '%s'\n", path);
+        return -1;
+    }
+
+    *count = 0;
+    while ((*count < ICOUNT_MAX_BASELINE) && (3 == fscanf(file, "%31s %lf %lf", baseline[*count].name,
+                                                          &baseline[*count].instructions, &baseline[*count].cycles)))
+    {
+        (*count)++;
+    }
+    fclose(file);
+    return 0;
+}
+
+static int icount_save_baseline(const char *path, const icount_result_t *results, int count)
+{
+    FILE *file = fopen(path, "w");
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot write baseline '%s'\n", path);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(file, "%s %.4f %.4f\n", results[i].name, results[i].instructions, results[i].cycles);
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Compares results with a baseline, returns the number of regressions.
+ *
+ * Only instructions gate the result: they are deterministic, while cycles are
+ * printed for context but still vary with the machine state.
+ */
+static int icount_compare(const icount_result_t *results, int count, const icount_result_t *baseline,
+                          int baselineCount)
+{
+    int regressions = 0;
+
+    printf("\n%-14s %12s %12s %9s\n", "vs baseline", "ins/msg", "base", "delta %");
+    for (int i = 0; i < count; i++)
+    {
+        for (int b = 0; b < baselineCount; b++)
+        {
+            if ((0 != strcmp(results[i].name, baseline[b].name)) || (0.0 >= baseline[b].instructions))
+            {
+                continue;
+            }
+
+            double delta = 100.0 * (results[i].instructions - baseline[b].instructions) / baseline[b].instructions;
+            int regressed = (delta > benchOptions.regressionPct);
+
+            printf("%-14s %12.3f %12.3f %+9.2f%s\n", results[i].name, results[i].instructions,
+                   baseline[b].instructions, delta, regressed ? "  REGRESSION" : "");
+            regressions += regressed;
+        }
+    }
+    return regressions;
+}
+
+int MCF_bench_icount(void)
+{
+    icount_result_t results[ICOUNT_SCENARIO_COUNT];
+    int measured = 1;
+
+    if (!MCF_perf_enabled())
+    {
+        MCF_perf_enable(0);
+    }
+
+    printf("%-14s %12s %12s\n", "scenario", "ins/msg", "cyc/msg");
+
+    for (size_t i = 0; i < ICOUNT_SCENARIO_COUNT; i++)
+    {
+        MCF_bench_ring_t ring;
+        MCF_perf_t perf;
+        uint64_t messages;
+
+        MCF_bench_ring_init(&ring, 1, benchOptions.ringSize, icount_parser);
+        MCF_perf_open(&perf);
+
+        ICOUNT_BEGIN(icountScenarios[i].name);
+        messages = icountScenarios[i].run(&ring, &perf);
+        ICOUNT_END(icountScenarios[i].name);
+
+        MCF_perf_close(&perf);
+        MCF_bench_ring_free(&ring);
+
+        snprintf(results[i].name, sizeof(results[i].name), "%s", icountScenarios[i].name);
+        results[i].instructions = (double)perf.value[MCF_PERF_INSTRUCTIONS] / (double)messages;
+        results[i].cycles = (double)perf.value[MCF_PERF_CYCLES] / (double)messages;
+
+        printf("%-14s", results[i].name);
+        if (MCF_perf_available(&perf, MCF_PERF_INSTRUCTIONS))
+        {
+            printf(" %12.3f", results[i].instructions);
+        }
+        else
+        {
+            printf(" %12s", "n/a");
+            measured = 0;
+        }
+        if (MCF_perf_available(&perf, MCF_PERF_CYCLES))
+        {
+            printf(" %12.3f\n", results[i].cycles);
+        }
+        else
+        {
+            printf(" %12s\n", "n/a");
+        }
+    }
+
+    if (!measured)
+    {
+        printf("perf counters unavailable; run under valgrind --tool=callgrind for instruction counts\n");
+        if ((NULL != benchOptions.baselineFile) || (NULL != benchOptions.saveBaselineFile))
+        {
+            fprintf(stderr, "baseline comparison needs perf instruction counters\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    if ((NULL != benchOptions.saveBaselineFile) &&
+        (0 != icount_save_baseline(benchOptions.saveBaselineFile, results, (int)ICOUNT_SCENARIO_COUNT)))
+    {
+        return 1;
+    }
+
+    if (NULL != benchOptions.baselineFile)
+    {
+        icount_result_t baseline[ICOUNT_MAX_BASELINE];
+        int baselineCount;
+
+        if (0 != icount_load_baseline(benchOptions.baselineFile, baseline, &baselineCount))
+        {
+            return 1;
+        }
+        if (0 != icount_compare(results, (int)ICOUNT_SCENARIO_COUNT, baseline, baselineCount))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
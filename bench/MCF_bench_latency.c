@@ -0,0 +1,166 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Per-call latency of MCF_send_* and MCF_receive.
+ *
+ * Every call is bracketed by cycle counter reads and recorded into an HDR-style
+ * histogram, so the report shows the tail (p99.99, max) and jitter instead of a
+ * mean. The cost of an empty timer bracket is reported as its own row.
+ * --cpus, --isolate and --noise control the environment of the run.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    MCF_bench_ring_t ring;
+    pthread_barrier_t start;
+    MCF_hist_t *send;
+    MCF_hist_t *receive;
+    uint64_t receiveCalls;
+} latency_run_t;
+
+static uint32_t latencyReceived;
+static uint32_t latencyErrors;
+
+static void latency_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 != latencyReceived)
+    {
+        latencyErrors++;
+    }
+    latencyReceived++;
+}
+
+static void *latency_producer(void *arg)
+{
+    latency_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    MCF_bench_isolate();
+    pthread_barrier_wait(&run->start);
+
+    for (uint32_t seq = 0; seq < benchOptions.messages; seq++)
+    {
+        while (0 == MCF_bench_ring_free_space(&run->ring.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+
+        uint64_t t0 = MCF_bench_ticks();
+        MCF_send_u32(&run->ring.tx, 1, seq);
+        uint64_t t1 = MCF_bench_ticks();
+
+        MCF_hist_record(run->send, t1 - t0);
+    }
+    return NULL;
+}
+
+static void *latency_consumer(void *arg)
+{
+    latency_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    MCF_bench_isolate();
+    pthread_barrier_wait(&run->start);
+
+    while (latencyReceived < benchOptions.messages)
+    {
+        uint32_t before = latencyReceived;
+
+        uint64_t t0 = MCF_bench_ticks();
+        MCF_receive(&run->ring.rx);
+        uint64_t t1 = MCF_bench_ticks();
+
+        if (before != latencyReceived)
+        {
+            MCF_hist_record(run->receive, t1 - t0);
+            run->receiveCalls++;
+        }
+        else
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void latency_print(const char *name, const MCF_hist_t *hist, double ticksPerNs)
+{
+    printf("%-10s %10llu %10llu %10llu %10llu %10llu %10.1f %10.1f\n", name, (unsigned long long)hist->min,
+           (unsigned long long)MCF_hist_percentile(hist, 50.0), (unsigned long long)MCF_hist_percentile(hist, 99.0),
+           (unsigned long long)MCF_hist_percentile(hist, 99.99), (unsigned long long)hist->max,
+           MCF_hist_stddev(hist), (double)hist->max / ticksPerNs);
+}
+
+int MCF_bench_latency(void)
+{
+    latency_run_t run = {0};
+    MCF_hist_t *timer = malloc(sizeof(*timer));
+    pthread_t producer;
+    pthread_t consumer;
+    double ticksPerNs = MCF_bench_ticks_per_ns();
+
+    run.send = malloc(sizeof(*run.send));
+    run.receive = malloc(sizeof(*run.receive));
+    MCF_hist_reset(run.send);
+    MCF_hist_reset(run.receive);
+    MCF_hist_reset(timer);
+
+    for (uint32_t i = 0; i < 100000u; i++)
+    {
+        uint64_t t0 = MCF_bench_ticks();
+        uint64_t t1 = MCF_bench_ticks();
+        MCF_hist_record(timer, t1 - t0);
+    }
+
+    latencyReceived = 0;
+    latencyErrors = 0;
+    MCF_bench_ring_init(&run.ring, 1, benchOptions.ringSize, latency_parser);
+    pthread_barrier_init(&run.start, NULL, 2);
+    MCF_bench_noise_start();
+
+    pthread_create(&consumer, NULL, latency_consumer, &run);
+    pthread_create(&producer, NULL, latency_producer, &run);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    MCF_bench_noise_stop();
+    pthread_barrier_destroy(&run.start);
+    MCF_bench_ring_free(&run.ring);
+
+    printf("ticks per ns %.3f, noise threads %d, isolate %s\n", ticksPerNs, benchOptions.noiseThreads,
+           benchOptions.isolate ? "on" : "off");
+    printf("%-10s %10s %10s %10s %10s %10s %10s %10s\n", "ticks", "min", "p50", "p99", "p99.99", "max", "jitter",
+           "max ns");
+    latency_print("timer", timer, ticksPerNs);
+    latency_print("send", run.send, ticksPerNs);
+    latency_print("receive", run.receive, ticksPerNs);
+    printf("receive: %.2f messages per call\n",
+           (0 != run.receiveCalls) ? (double)benchOptions.messages / (double)run.receiveCalls : 0.0);
+
+    free(timer);
+    free(run.send);
+    free(run.receive);
+
+    if (0 != latencyErrors)
+    {
+        fprintf(stderr, "latency: %u out-of-order messages\n", latencyErrors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * One MCF_log writer and three independent readers:
+ *
+ *     live    follows the end of the log from the start
+ *     late    joins halfway through and first replays everything retained
+ *     slow    spends LOG_SLOW_NS per message, so the writer laps it
+ *
+ * The writer appends benchOptions.messages messages at full speed, each
+ * carrying its own offset. Every reader checks that each message it gets holds
+ * the offset it was read at (a torn or misplaced read is an error) and that
+ * offsets only move forward; read plus lost must cover the log from where the
+ * reader started.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_CAPACITY 4096u
+#define LOG_SLOW_NS 200u
+
+typedef enum
+{
+    LOG_READER_LIVE = 0,
+    LOG_READER_LATE,
+    LOG_READER_SLOW,
+    LOG_READER_COUNT
+} log_reader_kind_t;
+
+static const char *const logReaderNames[LOG_READER_COUNT] = {"live", "late", "slow"};
+
+typedef struct
+{
+    MCF_Log_t log;
+    pthread_barrier_t start;
+    volatile int writerDone;
+} log_run_t;
+
+typedef struct
+{
+    log_run_t *run;
+    log_reader_kind_t kind;
+    MCF_LogReader_t reader;
+    uint64_t firstOffset;
+    uint64_t replayed;
+    uint64_t read;
+    uint64_t errors;
+    uint64_t ns;
+} log_reader_arg_t;
+
+static void *log_writer(void *arg)
+{
+    log_run_t *run = arg;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    for (uint32_t i = 0; i < benchOptions.messages; i++)
+    {
+        MCF_log_append_u32(&run->log, 1, i);
+    }
+    run->writerDone = 1;
+    return NULL;
+}
+
+static void *log_reader(void *arg)
+{
+    log_reader_arg_t *readerArg = arg;
+    log_run_t *run = readerArg->run;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    if (LOG_READER_LATE == readerArg->kind)
+    {
+        while (!run->writerDone && (MCF_log_end_offset(&run->log) < benchOptions.messages / 2u))
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+
+    uint64_t joinEnd = MCF_log_end_offset(&run->log);
+    uint64_t startNs = MCF_bench_now_ns();
+    MCF_log_reader_init(&readerArg->reader, &run->log,
+                        (LOG_READER_LATE == readerArg->kind) ? MCF_log_start_offset(&run->log) : 0u, NULL);
+    readerArg->firstOffset = readerArg->reader.offset;
+
+    for (;;)
+    {
+        uint64_t offset = readerArg->reader.offset;
+        MCF_Message_t msg;
+        int status = MCF_log_read(&readerArg->reader, &msg);
+
+        if (1 == status)
+        {
+            if (msg.u32 != (uint32_t)offset)
+            {
+                readerArg->errors++;
+            }
+            readerArg->read++;
+            readerArg->replayed += (offset < joinEnd);
+            if (LOG_READER_SLOW == readerArg->kind)
+            {
+                uint64_t workEnd = MCF_bench_now_ns() + LOG_SLOW_NS;
+                while (MCF_bench_now_ns() < workEnd)
+                {
+                }
+            }
+        }
+        else if (-1 == status)
+        {
+            if (readerArg->reader.offset <= offset)
+            {
+                readerArg->errors++;
+            }
+        }
+        else if (run->writerDone && (readerArg->reader.offset >= MCF_log_end_offset(&run->log)))
+        {
+            break;
+        }
+        else
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    readerArg->ns = MCF_bench_now_ns() - startNs;
+    return NULL;
+}
+
+int MCF_bench_log(void)
+{
+    log_run_t *run = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*run));
+    MCF_LogSlot_t *slots = aligned_alloc(MCF_CACHE_LINE_SIZE, LOG_CAPACITY * sizeof(*slots));
+    log_reader_arg_t args[LOG_READER_COUNT] = {0};
+    pthread_t readers[LOG_READER_COUNT];
+    pthread_t writer;
+    int result = 0;
+
+    MCF_log_init(&run->log, slots, LOG_CAPACITY);
+    run->writerDone = 0;
+    pthread_barrier_init(&run->start, NULL, LOG_READER_COUNT + 1u);
+
+    for (int r = 0; r < LOG_READER_COUNT; r++)
+    {
+        args[r].run = run;
+        args[r].kind = (log_reader_kind_t)r;
+        pthread_create(&readers[r], NULL, log_reader, &args[r]);
+    }
+    pthread_create(&writer, NULL, log_writer, run);
+    pthread_join(writer, NULL);
+    for (int r = 0; r < LOG_READER_COUNT; r++)
+    {
+        pthread_join(readers[r], NULL);
+    }
+
+    printf("capacity %u, %u messages appended\n", LOG_CAPACITY, benchOptions.messages);
+    printf("%-8s %12s %12s %12s %12s %10s %8s\n", "reader", "from offset", "read", "replayed", "lost", "ns/msg",
+           "errors");
+    for (int r = 0; r < LOG_READER_COUNT; r++)
+    {
+        log_reader_arg_t *readerArg = &args[r];
+
+        /* Every offset from the reader's start was either read or counted as lost. */
+        if (readerArg->read + readerArg->reader.lost != benchOptions.messages - readerArg->firstOffset)
+        {
+            readerArg->errors++;
+        }
+        printf("%-8s %12llu %12llu %12llu %12llu %10.2f %8llu\n", logReaderNames[r],
+               (unsigned long long)readerArg->firstOffset, (unsigned long long)readerArg->read,
+               (unsigned long long)readerArg->replayed, (unsigned long long)readerArg->reader.lost,
+               (0u != readerArg->read) ? (double)readerArg->ns / (double)readerArg->read : 0.0,
+               (unsigned long long)readerArg->errors);
+        result |= (0u != readerArg->errors);
+    }
+
+    pthread_barrier_destroy(&run->start);
+    free(slots);
+    free(run);
+    return result;
+}
@@ -0,0 +1,219 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * MPMC scaling: MCF_mpmc (fetch-and-add claiming) against the Vyukov queue (CAS
+ * claiming) with N producers and N consumers, N doubling up to the CPU count.
+ *
+ * Consumers race for messages, so per-producer order is not observable; the run
+ * instead checks that the count and the sum of all received values match what
+ * was sent (nothing lost, nothing duplicated).
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_bench_ref_queues.h"
+#include "MCF_mpmc.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Upper bound of producer (and consumer) threads per run. */
+#define MPMC_MAX_THREADS 128u
+
+typedef enum
+{
+    MPMC_FAA = 0,
+    MPMC_CAS,
+    MPMC_VARIANT_COUNT
+} mpmc_variant_t;
+
+static const char *const mpmcVariantNames[MPMC_VARIANT_COUNT] = {"mcf-mpmc-faa", "vyukov-cas"};
+
+typedef struct
+{
+    mpmc_variant_t variant;
+    uint32_t threads;
+    uint32_t perProducer;
+    MCF_Mpmc_t *mpmc;
+    MCF_ref_vyukov_t shared;
+    pthread_barrier_t start;
+    _Atomic uint64_t received;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t fullRetries;
+} mpmc_run_t;
+
+static _Thread_local uint64_t mpmcLocalSum;
+
+static void mpmc_parser(MCF_Message_t *msgBuf)
+{
+    mpmcLocalSum += msgBuf->u32;
+}
+
+static void *mpmc_producer(void *arg)
+{
+    mpmc_run_t *run = arg;
+    uint64_t retries = 0;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    for (uint32_t seq = 0; seq < run->perProducer; seq++)
+    {
+        if (MPMC_FAA == run->variant)
+        {
+            while (0 != MCF_mpmc_send_u32(run->mpmc, 0, seq))
+            {
+                retries++;
+                MCF_bench_relax(&spins);
+            }
+        }
+        else
+        {
+            while (!MCF_ref_vyukov_push(&run->shared, seq))
+            {
+                retries++;
+                MCF_bench_relax(&spins);
+            }
+        }
+    }
+    atomic_fetch_add(&run->fullRetries, retries);
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    mpmc_run_t *run = arg;
+    uint64_t total = (uint64_t)run->perProducer * run->threads;
+    uint32_t spins = 0;
+
+    mpmcLocalSum = 0;
+    pthread_barrier_wait(&run->start);
+
+    while (atomic_load_explicit(&run->received, memory_order_relaxed) < total)
+    {
+        uint32_t got = 0;
+
+        if (MPMC_FAA == run->variant)
+        {
+            got = MCF_mpmc_receive(run->mpmc);
+        }
+        else
+        {
+            uint32_t value;
+
+            while (MCF_ref_vyukov_pop(&run->shared, &value))
+            {
+                mpmcLocalSum += value;
+                got++;
+            }
+        }
+
+        if (0u != got)
+        {
+            atomic_fetch_add_explicit(&run->received, got, memory_order_relaxed);
+        }
+        else
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    atomic_fetch_add(&run->sum, mpmcLocalSum);
+    return NULL;
+}
+
+static uint32_t mpmc_cpu_count(void)
+{
+    cpu_set_t allowed;
+
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    return (uint32_t)CPU_COUNT(&allowed);
+}
+
+int MCF_bench_mpmc(void)
+{
+    uint32_t cpus = mpmc_cpu_count();
+    uint8_t order = 1;
+    int result = 0;
+
+    while ((order < 15u) && ((1u << order) < benchOptions.ringSize))
+    {
+        order++;
+    }
+
+    printf("capacity %u messages, %u CPUs\n", 1u << order, cpus);
+    printf("%-14s %9s %12s %12s %14s %8s\n", "queue", "threads", "ns/msg", "Mmsg/s", "full retries", "errors");
+
+    for (uint32_t threads = 1; threads <= MPMC_MAX_THREADS; threads *= 2u)
+    {
+        for (int variant = 0; variant < MPMC_VARIANT_COUNT; variant++)
+        {
+            mpmc_run_t *run = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*run));
+            MCF_Mpmc_t *mpmc = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*mpmc));
+            _Atomic uint64_t *entries = aligned_alloc(MCF_CACHE_LINE_SIZE, MCF_MPMC_ENTRIES(order) * sizeof(*entries));
+            MCF_Message_t *msgBuf = calloc(1u << order, sizeof(*msgBuf));
+            pthread_t producers[MPMC_MAX_THREADS];
+            pthread_t consumers[MPMC_MAX_THREADS];
+
+            *run = (mpmc_run_t){.variant = (mpmc_variant_t)variant, .threads = threads, .mpmc = mpmc};
+            run->perProducer = benchOptions.messages / threads;
+            if (MPMC_FAA == run->variant)
+            {
+                MCF_mpmc_init(mpmc, entries, msgBuf, order, mpmc_parser);
+            }
+            else
+            {
+                MCF_ref_vyukov_init(&run->shared, 1u << order);
+            }
+            pthread_barrier_init(&run->start, NULL, 2u * threads);
+
+            uint64_t startNs = MCF_bench_now_ns();
+            for (uint32_t t = 0; t < threads; t++)
+            {
+                pthread_create(&consumers[t], NULL, mpmc_consumer, run);
+                pthread_create(&producers[t], NULL, mpmc_producer, run);
+            }
+            for (uint32_t t = 0; t < threads; t++)
+            {
+                pthread_join(producers[t], NULL);
+                pthread_join(consumers[t], NULL);
+            }
+            uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+            uint64_t received = atomic_load(&run->received);
+            uint64_t expectedSum = (uint64_t)threads * run->perProducer * (run->perProducer - 1u) / 2u;
+            uint64_t errors =
+                (received != (uint64_t)threads * run->perProducer) || (atomic_load(&run->sum) != expectedSum);
+
+            printf("%-14s %9u %12.2f %12.2f %14llu %8llu\n", mpmcVariantNames[variant], threads,
+                   (double)elapsedNs / (double)received, (double)received * 1e3 / (double)elapsedNs,
+                   (unsigned long long)atomic_load(&run->fullRetries), (unsigned long long)errors);
+            result |= (0u != errors);
+
+            pthread_barrier_destroy(&run->start);
+            if (MPMC_CAS == run->variant)
+            {
+                MCF_ref_vyukov_free(&run->shared);
+            }
+            free(msgBuf);
+            free(entries);
+            free(mpmc);
+            free(run);
+        }
+
+        /* Beyond one producer per CPU the runs measure the scheduler rather than the queue. */
+        if (threads >= cpus)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
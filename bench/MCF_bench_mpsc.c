@@ -0,0 +1,251 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Many producers, one consumer: MCF_mpsc lanes against one shared CAS queue.
+ *
+ * The messages of a run are split evenly over the producer threads. Every
+ * message carries its producer and a per-producer sequence number, so the
+ * consumer checks that each producer's stream arrives complete and in order.
+ * Only the consumer is pinned (--cpus); producers float so their count can
+ * exceed the CPUs available.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_ref_queues.h"
+#include "MCF_mpsc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Bits of the shared-queue value holding the sequence number, the rest holds the producer. */
+#define MPSC_SEQ_BITS 26u
+#define MPSC_SEQ_MASK ((1u << MPSC_SEQ_BITS) - 1u)
+
+static const uint8_t mpscProducerCounts[] = {1, 2, 4, 8, 16, 32};
+
+typedef enum
+{
+    MPSC_LANES_RR = 0,
+    MPSC_LANES_BITMAP,
+    MPSC_LANES_DRR,
+    MPSC_SHARED_CAS,
+    MPSC_VARIANT_COUNT
+} mpsc_variant_t;
+
+static const char *const mpscVariantNames[MPSC_VARIANT_COUNT] = {"lanes-rr", "lanes-bitmap", "lanes-drr",
+                                                                         "shared-cas"};
+
+typedef struct
+{
+    mpsc_variant_t variant;
+    uint8_t producers;
+    uint32_t perProducer;
+    MCF_Mpsc_t *mpsc;
+    MCF_ref_vyukov_t shared;
+    pthread_barrier_t start;
+    uint64_t fullRetries;
+} mpsc_run_t;
+
+typedef struct
+{
+    mpsc_run_t *run;
+    uint8_t index;
+} mpsc_producer_arg_t;
+
+static uint32_t mpscExpected[MCF_MPSC_MAX_LANES];
+static uint64_t mpscReceived;
+static uint64_t mpscErrors;
+
+static inline void mpsc_check(uint32_t producer, uint32_t seq, uint32_t mask)
+{
+    if ((producer >= MCF_MPSC_MAX_LANES) || (seq != (mpscExpected[producer] & mask)))
+    {
+        mpscErrors++;
+    }
+    else
+    {
+        mpscExpected[producer]++;
+    }
+    mpscReceived++;
+}
+
+static void mpsc_parser(MCF_Message_t *msgBuf)
+{
+    mpsc_check(msgBuf->msgID, msgBuf->u32, UINT32_MAX);
+}
+
+static void *mpsc_producer(void *arg)
+{
+    mpsc_producer_arg_t *producerArg = arg;
+    mpsc_run_t *run = producerArg->run;
+    uint64_t retries = 0;
+    uint32_t spins = 0;
+    int lane = -1;
+
+    if (MPSC_SHARED_CAS != run->variant)
+    {
+        lane = MCF_mpsc_register(run->mpsc);
+    }
+    pthread_barrier_wait(&run->start);
+
+    for (uint32_t seq = 0; seq < run->perProducer; seq++)
+    {
+        if (MPSC_SHARED_CAS == run->variant)
+        {
+            uint32_t value = ((uint32_t)producerArg->index << MPSC_SEQ_BITS) | (seq & MPSC_SEQ_MASK);
+
+            while (!MCF_ref_vyukov_push(&run->shared, value))
+            {
+                retries++;
+                MCF_bench_relax(&spins);
+            }
+        }
+        else
+        {
+            /* The lane index doubles as msgID so the parser knows whose stream it is. */
+            while (0 != MCF_mpsc_send_u32(run->mpsc, (uint8_t)lane, (uint16_t)lane, seq))
+            {
+                retries++;
+                MCF_bench_relax(&spins);
+            }
+        }
+    }
+
+    __atomic_fetch_add(&run->fullRetries, retries, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void *mpsc_consumer(void *arg)
+{
+    mpsc_run_t *run = arg;
+    uint64_t total = (uint64_t)run->perProducer * run->producers;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+
+    while (mpscReceived < total)
+    {
+        uint64_t before = mpscReceived;
+
+        if (MPSC_SHARED_CAS == run->variant)
+        {
+            uint32_t value;
+
+            while (MCF_ref_vyukov_pop(&run->shared, &value))
+            {
+                mpsc_check(value >> MPSC_SEQ_BITS, value & MPSC_SEQ_MASK, MPSC_SEQ_MASK);
+            }
+        }
+        else
+        {
+            MCF_mpsc_receive(run->mpsc);
+        }
+
+        if (before == mpscReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void mpsc_run(mpsc_run_t *run)
+{
+    pthread_t producers[MCF_MPSC_MAX_LANES];
+    mpsc_producer_arg_t args[MCF_MPSC_MAX_LANES];
+    pthread_t consumer;
+
+    pthread_barrier_init(&run->start, NULL, run->producers + 1u);
+    pthread_create(&consumer, NULL, mpsc_consumer, run);
+    for (uint8_t p = 0; p < run->producers; p++)
+    {
+        args[p].run = run;
+        args[p].index = p;
+        pthread_create(&producers[p], NULL, mpsc_producer, &args[p]);
+    }
+    for (uint8_t p = 0; p < run->producers; p++)
+    {
+        pthread_join(producers[p], NULL);
+    }
+    pthread_join(consumer, NULL);
+    pthread_barrier_destroy(&run->start);
+}
+
+int MCF_bench_mpsc(void)
+{
+    int result = 0;
+
+    printf("%-14s %9s %12s %12s %14s %8s\n", "queue", "producers", "ns/msg", "Mmsg/s", "full retries", "errors");
+
+    for (size_t c = 0; c < sizeof(mpscProducerCounts) / sizeof(mpscProducerCounts[0]); c++)
+    {
+        for (int variant = 0; variant < MPSC_VARIANT_COUNT; variant++)
+        {
+            mpsc_run_t run = {.variant = (mpsc_variant_t)variant, .producers = mpscProducerCounts[c]};
+            MCF_Mpsc_t *mpsc = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*mpsc));
+            MCF_t *lanes = calloc(run.producers, sizeof(*lanes));
+            MCF_Indices_t *indices = aligned_alloc(MCF_CACHE_LINE_SIZE, run.producers * sizeof(*indices));
+            MCF_Message_t *msgBufs = calloc((size_t)run.producers * benchOptions.ringSize, sizeof(*msgBufs));
+
+            run.perProducer = benchOptions.messages / run.producers;
+            run.mpsc = mpsc;
+            if (MPSC_SHARED_CAS == run.variant)
+            {
+                /* Same total capacity as the lanes together. */
+                MCF_ref_vyukov_init(&run.shared, (size_t)run.producers * (benchOptions.ringSize - 1u));
+            }
+            else
+            {
+                static const MCF_MpscMerge_t merges[] = {MCF_MPSC_ROUND_ROBIN, MCF_MPSC_READY_BITMAP,
+                                                         MCF_MPSC_DEFICIT_ROUND_ROBIN};
+
+                MCF_mpsc_init(mpsc, lanes, indices, msgBufs, run.producers, benchOptions.ringSize, mpsc_parser,
+                              merges[run.variant]);
+            }
+
+            for (uint8_t p = 0; p < MCF_MPSC_MAX_LANES; p++)
+            {
+                mpscExpected[p] = 0;
+            }
+            mpscReceived = 0;
+            mpscErrors = 0;
+
+            uint64_t startNs = MCF_bench_now_ns();
+            mpsc_run(&run);
+            uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+            for (uint8_t p = 0; p < run.producers; p++)
+            {
+                if (run.perProducer != mpscExpected[p])
+                {
+                    mpscErrors++;
+                }
+            }
+
+            printf("%-14s %9u %12.2f %12.2f %14llu %8llu\n", mpscVariantNames[variant], run.producers,
+                   (double)elapsedNs / (double)mpscReceived, (double)mpscReceived * 1e3 / (double)elapsedNs,
+                   (unsigned long long)run.fullRetries, (unsigned long long)mpscErrors);
+            result |= (0 != mpscErrors);
+
+            if (MPSC_SHARED_CAS == run.variant)
+            {
+                MCF_ref_vyukov_free(&run.shared);
+            }
+            free(msgBufs);
+            free(indices);
+            free(lanes);
+            free(mpsc);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,210 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Open-loop load generator.
+ *
+ * The producer follows a fixed schedule: message i is due at start + i / rate,
+ * whether or not earlier sends were delayed by a full ring. Latency is measured
+ * from that intended send time to the msgParser invocation, so stalls are
+ * charged to every message queued behind them instead of being hidden
+ * (no coordinated omission). Sweeping the target rate gives the
+ * latency-vs-throughput curve and the saturation point of a configuration.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Duration of each point of the sweep. */
+#define OPENLOOP_POINT_NS 1000000000ull
+
+/** A point is saturated when it delivers less than this share of its target rate. */
+#define OPENLOOP_SATURATED_SHARE 0.95
+
+static const double openloopDefaultRates[] = {1e4, 3e4, 1e5, 3e5, 1e6, 3e6, 1e7, 3e7};
+
+typedef struct
+{
+    MCF_bench_ring_t ring;
+    pthread_barrier_t start;
+    double rate;
+    uint32_t messages;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint64_t *intendedNs;
+    uint32_t intendedMask;
+    MCF_hist_t *latency;
+} openloop_run_t;
+
+static openloop_run_t *openloopRun;
+static uint32_t openloopReceived;
+static uint32_t openloopErrors;
+
+static void openloop_parser(MCF_Message_t *msgBuf)
+{
+    uint64_t now = MCF_bench_now_ns();
+    uint32_t seq = msgBuf->u32;
+
+    if (seq != openloopReceived)
+    {
+        openloopErrors++;
+    }
+    MCF_hist_record(openloopRun->latency, now - openloopRun->intendedNs[seq & openloopRun->intendedMask]);
+    openloopReceived++;
+}
+
+static void *openloop_producer(void *arg)
+{
+    openloop_run_t *run = arg;
+    double intervalNs = 1e9 / run->rate;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    MCF_bench_isolate();
+    pthread_barrier_wait(&run->start);
+    run->startNs = MCF_bench_now_ns();
+
+    for (uint32_t seq = 0; seq < run->messages; seq++)
+    {
+        uint64_t intended = run->startNs + (uint64_t)((double)seq * intervalNs);
+
+        while (MCF_bench_now_ns() < intended)
+        {
+            MCF_bench_relax(&spins);
+        }
+        while (0 == MCF_bench_ring_free_space(&run->ring.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+
+        /* The slot is published by the send below, before the consumer can look it up. */
+        run->intendedNs[seq & run->intendedMask] = intended;
+        MCF_send_u32(&run->ring.tx, 1, seq);
+    }
+    return NULL;
+}
+
+static void *openloop_consumer(void *arg)
+{
+    openloop_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    MCF_bench_isolate();
+    pthread_barrier_wait(&run->start);
+
+    while (openloopReceived < run->messages)
+    {
+        uint32_t before = openloopReceived;
+
+        MCF_receive(&run->ring.rx);
+        if (before == openloopReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    run->endNs = MCF_bench_now_ns();
+    return NULL;
+}
+
+static int openloop_point(double rate, MCF_hist_t *latency, double *achieved)
+{
+    openloop_run_t run = {.rate = rate, .latency = latency};
+    pthread_t producer;
+    pthread_t consumer;
+    uint32_t tableSize = 1;
+
+    /* Intended times stay valid for twice the ring capacity, more than can be in flight. */
+    while (tableSize < 2u * benchOptions.ringSize)
+    {
+        tableSize <<= 1;
+    }
+    run.intendedMask = tableSize - 1u;
+    run.intendedNs = calloc(tableSize, sizeof(*run.intendedNs));
+    run.messages = (uint32_t)(rate * (double)OPENLOOP_POINT_NS / 1e9);
+    if (0 == run.messages)
+    {
+        run.messages = 1;
+    }
+
+    openloopRun = &run;
+    openloopReceived = 0;
+    openloopErrors = 0;
+    MCF_hist_reset(latency);
+    MCF_bench_ring_init(&run.ring, 1, benchOptions.ringSize, openloop_parser);
+    pthread_barrier_init(&run.start, NULL, 2);
+
+    pthread_create(&consumer, NULL, openloop_consumer, &run);
+    pthread_create(&producer, NULL, openloop_producer, &run);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    *achieved = (double)run.messages * 1e9 / (double)(run.endNs - run.startNs);
+
+    pthread_barrier_destroy(&run.start);
+    MCF_bench_ring_free(&run.ring);
+    free(run.intendedNs);
+    return (0 != openloopErrors);
+}
+
+int MCF_bench_openloop(void)
+{
+    const double *rates = openloopDefaultRates;
+    int rateCount = (int)(sizeof(openloopDefaultRates) / sizeof(openloopDefaultRates[0]));
+    MCF_hist_t *latency = malloc(sizeof(*latency));
+    double saturation = 0.0;
+    int result = 0;
+
+    if (0 < benchOptions.rateCount)
+    {
+        rates = benchOptions.rates;
+        rateCount = benchOptions.rateCount;
+    }
+
+    MCF_bench_noise_start();
+    printf("%14s %14s %12s %12s %12s %12s\n", "target msg/s", "achieved", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    for (int i = 0; i < rateCount; i++)
+    {
+        double achieved;
+
+        result |= openloop_point(rates[i], latency, &achieved);
+        printf("%14.0f %14.0f %12llu %12llu %12llu %12llu\n", rates[i], achieved,
+               (unsigned long long)MCF_hist_percentile(latency, 50.0),
+               (unsigned long long)MCF_hist_percentile(latency, 99.0),
+               (unsigned long long)MCF_hist_percentile(latency, 99.9), (unsigned long long)latency->max);
+
+        if ((0.0 == saturation) && (achieved < rates[i] * OPENLOOP_SATURATED_SHARE))
+        {
+            saturation = rates[i];
+        }
+    }
+
+    MCF_bench_noise_stop();
+    if (0.0 != saturation)
+    {
+        printf("saturated at %.0f msg/s (less than %.0f%% of the target delivered)\n", saturation,
+               OPENLOOP_SATURATED_SHARE * 100.0);
+    }
+    else
+    {
+        printf("not saturated within the swept rates\n");
+    }
+
+    free(latency);
+    if (0 != result)
+    {
+        fprintf(stderr, "openloop: out-of-order messages detected\n");
+    }
+    return result;
+}
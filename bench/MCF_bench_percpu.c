@@ -0,0 +1,204 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Short-lived producers: waves of threads that each send a small burst and exit,
+ * drained by one consumer. Compares MCF_percpu with restartable sequences, the
+ * same rings with the spinlock fallback, and the shared MCF_mpmc queue. The count
+ * and the sum of received values are checked.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_mpmc.h"
+#include "MCF_percpu.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** Messages sent by each short-lived producer thread. */
+#define PERCPU_BURST 1000u
+
+/** Producer threads alive at the same time, per CPU. */
+#define PERCPU_THREADS_PER_CPU 2u
+
+typedef enum
+{
+    PERCPU_RSEQ = 0,
+    PERCPU_LOCKED,
+    PERCPU_SHARED,
+    PERCPU_VARIANT_COUNT
+} percpu_variant_t;
+
+static const char *const percpuVariantNames[PERCPU_VARIANT_COUNT] = {"percpu-rseq", "percpu-locked",
+                                                                     "shared-mpmc"};
+
+typedef struct
+{
+    percpu_variant_t variant;
+    MCF_Percpu_t percpu;
+    MCF_Mpmc_t *mpmc;
+    uint64_t total;
+    _Atomic uint64_t sendNs;
+    _Atomic uint64_t fullRetries;
+} percpu_run_t;
+
+static uint64_t percpuReceived;
+static uint64_t percpuSum;
+
+static void percpu_parser(MCF_Message_t *msgBuf)
+{
+    percpuSum += msgBuf->u32;
+    percpuReceived++;
+}
+
+static void *percpu_producer(void *arg)
+{
+    percpu_run_t *run = arg;
+    uint64_t retries = 0;
+    uint32_t spins = 0;
+    uint64_t startNs = MCF_bench_now_ns();
+
+    for (uint32_t seq = 0; seq < PERCPU_BURST; seq++)
+    {
+        int result;
+
+        do
+        {
+            result = (PERCPU_SHARED == run->variant) ? MCF_mpmc_send_u32(run->mpmc, 0, seq)
+                                                     : MCF_percpu_send_u32(&run->percpu, 0, seq);
+            if (0 != result)
+            {
+                retries++;
+                MCF_bench_relax(&spins);
+            }
+        } while (0 != result);
+    }
+
+    atomic_fetch_add(&run->sendNs, MCF_bench_now_ns() - startNs);
+    atomic_fetch_add(&run->fullRetries, retries);
+    return NULL;
+}
+
+static void *percpu_consumer(void *arg)
+{
+    percpu_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    while (percpuReceived < run->total)
+    {
+        uint64_t before = percpuReceived;
+
+        if (PERCPU_SHARED == run->variant)
+        {
+            MCF_mpmc_receive(run->mpmc);
+        }
+        else
+        {
+            MCF_percpu_receive(&run->percpu);
+        }
+        if (before == percpuReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+int MCF_bench_percpu(void)
+{
+    uint16_t cpus = (uint16_t)sysconf(_SC_NPROCESSORS_CONF);
+    uint32_t threads = PERCPU_THREADS_PER_CPU * cpus;
+    uint32_t waves = benchOptions.messages / (threads * PERCPU_BURST);
+    uint8_t order = 1;
+    int result = 0;
+
+    while ((order < 15u) && ((1u << order) < benchOptions.ringSize))
+    {
+        order++;
+    }
+    if (0u == waves)
+    {
+        waves = 1;
+    }
+
+    printf("%u CPUs, waves of %u threads x %u messages\n", cpus, threads, PERCPU_BURST);
+    printf("%-14s %12s %12s %14s %8s\n", "channel", "ns/msg", "send ns/msg", "full retries", "errors");
+
+    for (int variant = 0; variant < PERCPU_VARIANT_COUNT; variant++)
+    {
+        percpu_run_t *run = malloc(sizeof(*run));
+        MCF_t *rings = calloc(cpus, sizeof(*rings));
+        MCF_PercpuIndices_t *indices = aligned_alloc(MCF_CACHE_LINE_SIZE, cpus * sizeof(*indices));
+        MCF_Message_t *msgBufs = calloc((size_t)cpus * benchOptions.ringSize, sizeof(*msgBufs));
+        MCF_Mpmc_t *mpmc = aligned_alloc(MCF_CACHE_LINE_SIZE, sizeof(*mpmc));
+        _Atomic uint64_t *entries = aligned_alloc(MCF_CACHE_LINE_SIZE, MCF_MPMC_ENTRIES(order) * sizeof(*entries));
+        MCF_Message_t *mpmcBuf = calloc(1u << order, sizeof(*mpmcBuf));
+        pthread_t *producers = calloc(threads, sizeof(*producers));
+        pthread_t consumer;
+
+        *run = (percpu_run_t){.variant = (percpu_variant_t)variant, .mpmc = mpmc};
+        run->total = (uint64_t)waves * threads * PERCPU_BURST;
+        MCF_percpu_init(&run->percpu, rings, indices, msgBufs, cpus, benchOptions.ringSize, percpu_parser);
+        MCF_mpmc_init(mpmc, entries, mpmcBuf, order, percpu_parser);
+
+        if ((PERCPU_RSEQ == run->variant) && !run->percpu.useRseq)
+        {
+            printf("%-14s %12s   (restartable sequences unavailable)\n", percpuVariantNames[variant], "n/a");
+        }
+        else
+        {
+            if (PERCPU_LOCKED == run->variant)
+            {
+                run->percpu.useRseq = 0;
+            }
+            percpuReceived = 0;
+            percpuSum = 0;
+
+            uint64_t startNs = MCF_bench_now_ns();
+            pthread_create(&consumer, NULL, percpu_consumer, run);
+            for (uint32_t wave = 0; wave < waves; wave++)
+            {
+                for (uint32_t t = 0; t < threads; t++)
+                {
+                    pthread_create(&producers[t], NULL, percpu_producer, run);
+                }
+                for (uint32_t t = 0; t < threads; t++)
+                {
+                    pthread_join(producers[t], NULL);
+                }
+            }
+            pthread_join(consumer, NULL);
+            uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+            uint64_t expectedSum = run->total / PERCPU_BURST * ((uint64_t)PERCPU_BURST * (PERCPU_BURST - 1u) / 2u);
+            uint64_t errors = (percpuReceived != run->total) || (percpuSum != expectedSum);
+
+            printf("%-14s %12.2f %12.2f %14llu %8llu\n", percpuVariantNames[variant],
+                   (double)elapsedNs / (double)percpuReceived,
+                   (double)atomic_load(&run->sendNs) / (double)percpuReceived,
+                   (unsigned long long)atomic_load(&run->fullRetries), (unsigned long long)errors);
+            result |= (0u != errors);
+        }
+
+        free(producers);
+        free(mpmcBuf);
+        free(entries);
+        free(mpmc);
+        free(msgBufs);
+        free(indices);
+        free(rings);
+        free(run);
+    }
+
+    return result;
+}
@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench_perf.h"
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int perfEnabled;
+static uint64_t perfHitmRaw;
+
+static const char *const perfNames[MCF_PERF_EVENT_COUNT] = {"cyc", "ins", "miss", "hitm"};
+
+static int perf_open_event(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    /* Count the calling thread on whatever CPU it runs. */
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+void MCF_perf_enable(uint64_t hitmRaw)
+{
+    perfEnabled = 1;
+    perfHitmRaw = hitmRaw;
+}
+
+int MCF_perf_enabled(void)
+{
+    return perfEnabled;
+}
+
+void MCF_perf_open(MCF_perf_t *perf)
+{
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        perf->fd[i] = -1;
+        perf->value[i] = 0;
+    }
+    perf->available = 0;
+
+    if (!perfEnabled)
+    {
+        return;
+    }
+
+    perf->fd[MCF_PERF_CYCLES] = perf_open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    perf->fd[MCF_PERF_INSTRUCTIONS] = perf_open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    perf->fd[MCF_PERF_CACHE_MISSES] = perf_open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    if (0 != perfHitmRaw)
+    {
+        perf->fd[MCF_PERF_HITM] = perf_open_event(PERF_TYPE_RAW, perfHitmRaw);
+    }
+
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        if (0 <= perf->fd[i])
+        {
+            perf->available |= (1u << i);
+        }
+    }
+}
+
+void MCF_perf_start(MCF_perf_t *perf)
+{
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        if (0 <= perf->fd[i])
+        {
+            ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void MCF_perf_stop(MCF_perf_t *perf)
+{
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        uint64_t count = 0;
+
+        if (0 <= perf->fd[i])
+        {
+            ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (sizeof(count) == read(perf->fd[i], &count, sizeof(count)))
+            {
+                perf->value[i] += count;
+            }
+        }
+    }
+}
+
+void MCF_perf_close(MCF_perf_t *perf)
+{
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        if (0 <= perf->fd[i])
+        {
+            close(perf->fd[i]);
+            perf->fd[i] = -1;
+        }
+    }
+}
+
+int MCF_perf_available(const MCF_perf_t *perf, MCF_perf_event_t event)
+{
+    return 0 != (perf->available & (1u << event));
+}
+
+void MCF_perf_merge(MCF_perf_t *total, const MCF_perf_t *part)
+{
+    for (int i = 0; i < MCF_PERF_EVENT_COUNT; i++)
+    {
+        total->value[i] += part->value[i];
+    }
+    total->available &= part->available;
+}
+
+const char *MCF_perf_name(MCF_perf_event_t event)
+{
+    return perfNames[event];
+}
@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_BENCH_PERF_H_
+#define MULTICORE_FIFO_MCF_BENCH_PERF_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Hardware events collected by the benchmark harness.
+ *
+ * - `MCF_PERF_CYCLES`: CPU cycles spent by the measuring thread.
+ * - `MCF_PERF_INSTRUCTIONS`: Retired instructions.
+ * - `MCF_PERF_CACHE_MISSES`: Last level cache misses.
+ * - `MCF_PERF_HITM`: Loads that hit a line modified in another core's cache.
+ *   There is no generic perf event for it, so it is only counted when a raw
+ *   event code for the running microarchitecture is configured.
+ */
+typedef enum
+{
+    MCF_PERF_CYCLES = 0,
+    MCF_PERF_INSTRUCTIONS,
+    MCF_PERF_CACHE_MISSES,
+    MCF_PERF_HITM,
+    MCF_PERF_EVENT_COUNT
+} MCF_perf_event_t;
+
+/**
+ * @brief Per-thread counter set.
+ *
+ * - `fd`: perf_event file descriptors, -1 for events that could not be opened.
+ * - `value`: Counts accumulated between `MCF_perf_start()` and `MCF_perf_stop()`.
+ * - `available`: Bit mask of the events that were counted, kept after `MCF_perf_close()`.
+ */
+typedef struct
+{
+    int fd[MCF_PERF_EVENT_COUNT];
+    uint64_t value[MCF_PERF_EVENT_COUNT];
+    uint32_t available;
+} MCF_perf_t;
+
+/**
+ * @brief Enables counter collection for all following `MCF_perf_open()` calls.
+ *
+ * @param hitmRaw Raw PERF_TYPE_RAW config of the HITM event, 0 to skip it
+ *                (e.g. 0x04d2 for MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM on Skylake).
+ */
+void MCF_perf_enable(uint64_t hitmRaw);
+
+/**
+ * @brief Returns non-zero when counter collection was enabled.
+ */
+int MCF_perf_enabled(void);
+
+/**
+ * @brief Opens the configured counters for the calling thread.
+ *
+ * Events that are not supported or not permitted (see perf_event_paranoid) are
+ * left closed and reported as unavailable. Does nothing when collection is disabled.
+ */
+void MCF_perf_open(MCF_perf_t *perf);
+
+/**
+ * @brief Resets and starts the counters of the calling thread.
+ */
+void MCF_perf_start(MCF_perf_t *perf);
+
+/**
+ * @brief Stops the counters and adds their values to `perf->value`.
+ */
+void MCF_perf_stop(MCF_perf_t *perf);
+
+/**
+ * @brief Closes all counters of the set.
+ */
+void MCF_perf_close(MCF_perf_t *perf);
+
+/**
+ * @brief Returns non-zero when the event was counted by the set.
+ */
+int MCF_perf_available(const MCF_perf_t *perf, MCF_perf_event_t event);
+
+/**
+ * @brief Adds the counts of `part` to `total`.
+ *
+ * An event stays available in `total` only if it was counted by every merged set,
+ * so per-message figures never mix threads that could and could not count it.
+ * Start `total` zeroed with `available` set to all ones.
+ */
+void MCF_perf_merge(MCF_perf_t *total, const MCF_perf_t *part);
+
+/**
+ * @brief Returns the short column name of the event.
+ */
+const char *MCF_perf_name(MCF_perf_event_t event);
+
+#endif /* MULTICORE_FIFO_MCF_BENCH_PERF_H_ */
@@ -0,0 +1,262 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#ifndef MULTICORE_FIFO_MCF_BENCH_REF_QUEUES_H_
+#define MULTICORE_FIFO_MCF_BENCH_REF_QUEUES_H_
+
+/*
+ * Header-only reference queues used as baselines by the comparison benchmark.
+ *
+ * They are compact C11 re-implementations of well known designs, carrying the
+ * same 32-bit payload the MCF benchmarks send:
+ * - Lamport ring: single producer/consumer, both indices read on every operation.
+ * - Rigtorp-style SPSC: indices on their own cache lines, each side caches the
+ *   other side's index and only re-reads it when the cached value says full/empty.
+ * - Vyukov MPMC: bounded array of cells with per-cell sequence numbers, CAS on
+ *   the shared enqueue/dequeue positions.
+ *
+ * Capacities are rounded up to a power of two.
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MCF_REF_CACHE_LINE 64
+
+static inline size_t MCF_ref_pow2(size_t value)
+{
+    size_t pow2 = 2;
+
+    while (pow2 < value)
+    {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Lamport ring                                                              */
+/* ------------------------------------------------------------------------- */
+
+typedef struct
+{
+    _Atomic size_t head;
+    _Atomic size_t tail;
+    size_t mask;
+    uint32_t *slots;
+} MCF_ref_lamport_t;
+
+static inline void MCF_ref_lamport_init(MCF_ref_lamport_t *q, size_t capacity)
+{
+    size_t size = MCF_ref_pow2(capacity);
+
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->mask = size - 1;
+    q->slots = calloc(size, sizeof(*q->slots));
+}
+
+static inline void MCF_ref_lamport_free(MCF_ref_lamport_t *q)
+{
+    free(q->slots);
+}
+
+static inline int MCF_ref_lamport_push(MCF_ref_lamport_t *q, uint32_t value)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&q->tail, memory_order_acquire) > q->mask)
+    {
+        return 0;
+    }
+    q->slots[head & q->mask] = value;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 1;
+}
+
+static inline int MCF_ref_lamport_pop(MCF_ref_lamport_t *q, uint32_t *value)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail == atomic_load_explicit(&q->head, memory_order_acquire))
+    {
+        return 0;
+    }
+    *value = q->slots[tail & q->mask];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Rigtorp-style SPSC                                                        */
+/* ------------------------------------------------------------------------- */
+
+typedef struct
+{
+    _Alignas(MCF_REF_CACHE_LINE) _Atomic size_t head;
+    size_t tailCache;
+    _Alignas(MCF_REF_CACHE_LINE) _Atomic size_t tail;
+    size_t headCache;
+    _Alignas(MCF_REF_CACHE_LINE) size_t mask;
+    uint32_t *slots;
+} MCF_ref_rigtorp_t;
+
+static inline void MCF_ref_rigtorp_init(MCF_ref_rigtorp_t *q, size_t capacity)
+{
+    size_t size = MCF_ref_pow2(capacity);
+
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->tailCache = 0;
+    q->headCache = 0;
+    q->mask = size - 1;
+    q->slots = calloc(size, sizeof(*q->slots));
+}
+
+static inline void MCF_ref_rigtorp_free(MCF_ref_rigtorp_t *q)
+{
+    free(q->slots);
+}
+
+static inline int MCF_ref_rigtorp_push(MCF_ref_rigtorp_t *q, uint32_t value)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if (head - q->tailCache > q->mask)
+    {
+        q->tailCache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head - q->tailCache > q->mask)
+        {
+            return 0;
+        }
+    }
+    q->slots[head & q->mask] = value;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 1;
+}
+
+static inline int MCF_ref_rigtorp_pop(MCF_ref_rigtorp_t *q, uint32_t *value)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail == q->headCache)
+    {
+        q->headCache = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail == q->headCache)
+        {
+            return 0;
+        }
+    }
+    *value = q->slots[tail & q->mask];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Vyukov bounded MPMC                                                       */
+/* ------------------------------------------------------------------------- */
+
+typedef struct
+{
+    _Atomic size_t sequence;
+    uint32_t value;
+} MCF_ref_vyukov_cell_t;
+
+typedef struct
+{
+    _Alignas(MCF_REF_CACHE_LINE) _Atomic size_t enqueuePos;
+    _Alignas(MCF_REF_CACHE_LINE) _Atomic size_t dequeuePos;
+    _Alignas(MCF_REF_CACHE_LINE) size_t mask;
+    MCF_ref_vyukov_cell_t *cells;
+} MCF_ref_vyukov_t;
+
+static inline void MCF_ref_vyukov_init(MCF_ref_vyukov_t *q, size_t capacity)
+{
+    size_t size = MCF_ref_pow2(capacity);
+
+    atomic_init(&q->enqueuePos, 0);
+    atomic_init(&q->dequeuePos, 0);
+    q->mask = size - 1;
+    q->cells = calloc(size, sizeof(*q->cells));
+    for (size_t i = 0; i < size; i++)
+    {
+        atomic_init(&q->cells[i].sequence, i);
+    }
+}
+
+static inline void MCF_ref_vyukov_free(MCF_ref_vyukov_t *q)
+{
+    free(q->cells);
+}
+
+static inline int MCF_ref_vyukov_push(MCF_ref_vyukov_t *q, uint32_t value)
+{
+    size_t pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);
+
+    for (;;)
+    {
+        MCF_ref_vyukov_cell_t *cell = &q->cells[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (0 == diff)
+        {
+            if (atomic_compare_exchange_weak_explicit(&q->enqueuePos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                cell->value = value;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                return 1;
+            }
+        }
+        else if (0 > diff)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&q->enqueuePos, memory_order_relaxed);
+        }
+    }
+}
+
+static inline int MCF_ref_vyukov_pop(MCF_ref_vyukov_t *q, uint32_t *value)
+{
+    size_t pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+
+    for (;;)
+    {
+        MCF_ref_vyukov_cell_t *cell = &q->cells[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (0 == diff)
+        {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeuePos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                *value = cell->value;
+                atomic_store_explicit(&cell->sequence, pos + q->mask + 1, memory_order_release);
+                return 1;
+            }
+        }
+        else if (0 > diff)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&q->dequeuePos, memory_order_relaxed);
+        }
+    }
+}
+
+#endif /* MULTICORE_FIFO_MCF_BENCH_REF_QUEUES_H_ */
@@ -0,0 +1,600 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Scenario runner: executes benchmark descriptions read from `key = value` files
+ * (see bench/scenarios/) and writes the results as JSON.
+ *
+ * Every producer owns one MCF ring (MCF is single producer / single consumer);
+ * producer p feeds consumer p % consumers, which polls all its rings with
+ * MCF_receive. Payloads carry per-producer sequence numbers that the consumers
+ * verify.
+ *
+ * Keys:
+ *   name          scenario label
+ *   producers     producer threads (1..64)
+ *   consumers     consumer threads (1..producers)
+ *   producer_cpus CPU list the producers are pinned to in turn, e.g. 0,1,2,3
+ *   consumer_cpus CPU list for the consumers
+ *   ring_size     ring capacity in messages (2..65535)
+ *   ring_bytes    ring capacity in bytes, alternative to ring_size
+ *   layout        packed | padded head/tail placement
+ *   batch         messages sent per producer burst
+ *   mix           weighted payload types, e.g. "u32:3 f32:1 i16:1"
+ *   rate          messages per second per producer, 0 for flat out
+ *   duration      run time in seconds
+ */
+
+#include "MCF_bench.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENARIO_MAX_THREADS 64
+#define SCENARIO_MAX_CPUS 64
+
+typedef enum
+{
+    SCENARIO_U16 = 0,
+    SCENARIO_I16,
+    SCENARIO_U32,
+    SCENARIO_I32,
+    SCENARIO_F32,
+    SCENARIO_TYPE_COUNT
+} scenario_type_t;
+
+static const char *const scenarioTypeNames[SCENARIO_TYPE_COUNT] = {"u16", "i16", "u32", "i32", "f32"};
+
+typedef struct
+{
+    char name[64];
+    int producers;
+    int consumers;
+    int producerCpus[SCENARIO_MAX_CPUS];
+    int producerCpuCount;
+    int consumerCpus[SCENARIO_MAX_CPUS];
+    int consumerCpuCount;
+    uint16_t ringSize;
+    int padded;
+    uint16_t batch;
+    uint32_t mix[SCENARIO_TYPE_COUNT];
+    double rate;
+    double duration;
+} scenario_config_t;
+
+typedef struct
+{
+    MCF_bench_ring_t ring;
+    int cpu;
+    uint64_t sent;
+    uint64_t fullWaits;
+    pthread_t thread;
+} scenario_producer_t;
+
+typedef struct
+{
+    int index;
+    int cpu;
+    uint64_t receiveCalls;
+    pthread_t thread;
+} scenario_consumer_t;
+
+typedef struct
+{
+    const scenario_config_t *config;
+    scenario_producer_t producer[SCENARIO_MAX_THREADS];
+    scenario_consumer_t consumer[SCENARIO_MAX_THREADS];
+    pthread_barrier_t start;
+    volatile int stop;
+    uint64_t startNs;
+} scenario_run_t;
+
+static scenario_run_t *scenarioRun;
+
+/* Consumer-side state per producer; each producer is drained by exactly one consumer. */
+static uint32_t scenarioExpected[SCENARIO_MAX_THREADS];
+static uint64_t scenarioReceived[SCENARIO_MAX_THREADS];
+static uint64_t scenarioErrors[SCENARIO_MAX_THREADS];
+
+/* msgID layout: producer index in the upper bits, payload type in the low 3 bits. */
+static void scenario_parser(MCF_Message_t *msgBuf)
+{
+    uint16_t producer = msgBuf->msgID >> 3;
+    uint32_t seq = scenarioExpected[producer];
+    int ok;
+
+    switch ((scenario_type_t)(msgBuf->msgID & 7u)) {
+    case SCENARIO_U16:
+        ok = (msgBuf->u16 == (uint16_t)seq);
+        break;
+    case SCENARIO_I16:
+        ok = (msgBuf->i16 == (int16_t)(uint16_t)seq);
+        break;
+    case SCENARIO_U32:
+        ok = (msgBuf->u32 == seq);
+        break;
+    case SCENARIO_I32:
+        ok = (msgBuf->i32 == (int32_t)seq);
+        break;
+    default:
+        ok = (msgBuf->f32 == (float)(seq & 0xffffffu));
+        break;
+    }
+
+    scenarioErrors[producer] += !ok;
+    scenarioExpected[producer] = seq + 1;
+    scenarioReceived[producer]++;
+}
+
+static void scenario_send(MCF_t *tx, uint16_t producer, scenario_type_t type, uint32_t seq)
+{
+    uint16_t msgID = (uint16_t)((producer << 3) | type);
+
+    switch (type) {
+    case SCENARIO_U16:
+        MCF_send_u16(tx, msgID, (uint16_t)seq);
+        break;
+    case SCENARIO_I16:
+        MCF_send_i16(tx, msgID, (int16_t)(uint16_t)seq);
+        break;
+    case SCENARIO_U32:
+        MCF_send_u32(tx, msgID, seq);
+        break;
+    case SCENARIO_I32:
+        MCF_send_i32(tx, msgID, (int32_t)seq);
+        break;
+    default:
+        MCF_send_f32(tx, msgID, (float)(seq & 0xffffffu));
+        break;
+    }
+}
+
+static void *scenario_producer(void *arg)
+{
+    scenario_producer_t *self = arg;
+    const scenario_config_t *config = scenarioRun->config;
+    uint16_t index = (uint16_t)(self - scenarioRun->producer);
+    scenario_type_t types[64];
+    uint32_t typeCount = 0;
+    uint64_t intervalNs = (0.0 < config->rate) ? (uint64_t)(1e9 / config->rate) : 0;
+    uint64_t durationNs = (uint64_t)(config->duration * 1e9);
+    uint32_t spins = 0;
+    uint32_t seq = 0;
+
+    /* Expand the weighted mix into a repeating pattern of payload types. */
+    for (int t = 0; t < SCENARIO_TYPE_COUNT; t++)
+    {
+        for (uint32_t w = 0; (w < config->mix[t]) && (typeCount < 64); w++)
+        {
+            types[typeCount++] = (scenario_type_t)t;
+        }
+    }
+
+    MCF_bench_pin(self->cpu);
+    pthread_barrier_wait(&scenarioRun->start);
+
+    uint64_t start = MCF_bench_now_ns();
+    uint64_t next = start;
+
+    for (;;)
+    {
+        uint64_t now = MCF_bench_now_ns();
+
+        if (now - start >= durationNs)
+        {
+            break;
+        }
+        if ((0 != intervalNs) && (now < next))
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+
+        if (MCF_bench_ring_free_space(&self->ring.tx) < config->batch)
+        {
+            self->fullWaits++;
+            MCF_bench_relax(&spins);
+            continue;
+        }
+
+        for (uint16_t i = 0; i < config->batch; i++, seq++)
+        {
+            scenario_send(&self->ring.tx, index, types[seq % typeCount], seq);
+        }
+        self->sent += config->batch;
+        next += intervalNs * config->batch;
+    }
+    return NULL;
+}
+
+static int scenario_pending(const scenario_consumer_t *self)
+{
+    for (int p = self->index; p < scenarioRun->config->producers; p += scenarioRun->config->consumers)
+    {
+        const MCF_t *rx = &scenarioRun->producer[p].ring.rx;
+
+        if (__atomic_load_n(rx->head, __ATOMIC_ACQUIRE) != *(rx->tail))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *scenario_consumer(void *arg)
+{
+    scenario_consumer_t *self = arg;
+    const scenario_config_t *config = scenarioRun->config;
+
+    MCF_bench_pin(self->cpu);
+    pthread_barrier_wait(&scenarioRun->start);
+
+    while (!scenarioRun->stop || scenario_pending(self))
+    {
+        for (int p = self->index; p < config->producers; p += config->consumers)
+        {
+            MCF_receive(&scenarioRun->producer[p].ring.rx);
+            self->receiveCalls++;
+        }
+    }
+    return NULL;
+}
+
+static char *scenario_trim(char *text)
+{
+    char *end;
+
+    while (isspace((unsigned char)*text))
+    {
+        text++;
+    }
+    end = text + strlen(text);
+    while ((end > text) && isspace((unsigned char)end[-1]))
+    {
+        *--end = '\0';
+    }
+    return text;
+}
+
+static int scenario_parse_cpus(const char *value, int *cpus, int *count)
+{
+    char *end;
+
+    *count = 0;
+    while (('\0' != *value) && (*count < SCENARIO_MAX_CPUS))
+    {
+        cpus[(*count)++] = (int)strtol(value, &end, 0);
+        if (end == value)
+        {
+            return -1;
+        }
+        value = (',' == *end) ? end + 1 : end;
+    }
+    return 0;
+}
+
+static int scenario_parse_mix(char *value, uint32_t *mix)
+{
+    memset(mix, 0, SCENARIO_TYPE_COUNT * sizeof(*mix));
+
+    for (char *item = strtok(value, " ,"); NULL != item; item = strtok(NULL, " ,"))
+    {
+        char *weight = strchr(item, ':');
+        int found = 0;
+
+        if (NULL != weight)
+        {
+            *weight++ = '\0';
+        }
+        for (int t = 0; t < SCENARIO_TYPE_COUNT; t++)
+        {
+            if (0 == strcmp(item, scenarioTypeNames[t]))
+            {
+                mix[t] = (NULL != weight) ? (uint32_t)strtoul(weight, NULL, 0) : 1u;
+                found = 1;
+            }
+        }
+        if (!found)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int scenario_load(const char *path, scenario_config_t *config)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    int lineNo = 0;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "%s: cannot open scenario\n", path);
+        return -1;
+    }
+
+    memset(config, 0, sizeof(*config));
+    snprintf(config->name, sizeof(config->name), "%s", path);
+    config->producers = 1;
+    config->consumers = 1;
+    config->ringSize = benchOptions.ringSize;
+    config->padded = 1;
+    config->batch = 1;
+    config->mix[SCENARIO_U32] = 1;
+    config->duration = 1.0;
+
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        char *comment = strchr(line, '#');
+        char *eq;
+        char *key;
+        char *value;
+        int ok = 1;
+
+        lineNo++;
+        if (NULL != comment)
+        {
+            *comment = '\0';
+        }
+        key = scenario_trim(line);
+        if ('\0' == *key)
+        {
+            continue;
+        }
+        eq = strchr(key, '=');
+        if (NULL == eq)
+        {
+            fprintf(stderr, "%s:%d: expected key = value\n", path, lineNo);
+            fclose(file);
+            return -1;
+        }
+        *eq = '\0';
+        key = scenario_trim(key);
+        value = scenario_trim(eq + 1);
+
+        if (0 == strcmp(key, "name"))
+        {
+            snprintf(config->name, sizeof(config->name), "%s", value);
+        }
+        else if (0 == strcmp(key, "producers"))
+        {
+            config->producers = atoi(value);
+        }
+        else if (0 == strcmp(key, "consumers"))
+        {
+            config->consumers = atoi(value);
+        }
+        else if (0 == strcmp(key, "producer_cpus"))
+        {
+            ok = (0 == scenario_parse_cpus(value, config->producerCpus, &config->producerCpuCount));
+        }
+        else if (0 == strcmp(key, "consumer_cpus"))
+        {
+            ok = (0 == scenario_parse_cpus(value, config->consumerCpus, &config->consumerCpuCount));
+        }
+        else if ((0 == strcmp(key, "ring_size")) || (0 == strcmp(key, "ring_bytes")))
+        {
+            unsigned long size = strtoul(value, NULL, 0);
+
+            if ('b' == key[5])
+            {
+                size /= sizeof(MCF_Message_t);
+            }
+            if (size > UINT16_MAX)
+            {
+                fprintf(stderr, "%s:%d: ring limited to %u messages (uint16_t indices)\n", path, lineNo, UINT16_MAX);
+                size = UINT16_MAX;
+            }
+            config->ringSize = (uint16_t)size;
+        }
+        else if (0 == strcmp(key, "layout"))
+        {
+            ok = (0 == strcmp(value, "padded")) || (0 == strcmp(value, "packed"));
+            config->padded = (0 == strcmp(value, "padded"));
+        }
+        else if (0 == strcmp(key, "batch"))
+        {
+            config->batch = (uint16_t)strtoul(value, NULL, 0);
+        }
+        else if (0 == strcmp(key, "mix"))
+        {
+            ok = (0 == scenario_parse_mix(value, config->mix));
+        }
+        else if (0 == strcmp(key, "rate"))
+        {
+            config->rate = strtod(value, NULL);
+        }
+        else if (0 == strcmp(key, "duration"))
+        {
+            config->duration = strtod(value, NULL);
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d: unknown key '%s'\n", path, lineNo, key);
+            ok = 0;
+        }
+
+        if (!ok)
+        {
+            fprintf(stderr, "%s:%d: invalid value for '%s'\n", path, lineNo, key);
+            fclose(file);
+            return -1;
+        }
+    }
+    fclose(file);
+
+    uint32_t mixTotal = 0;
+    for (int t = 0; t < SCENARIO_TYPE_COUNT; t++)
+    {
+        mixTotal += config->mix[t];
+    }
+
+    if ((1 > config->producers) || (SCENARIO_MAX_THREADS < config->producers) || (1 > config->consumers) ||
+        (config->consumers > config->producers) || (2 > config->ringSize) || (0 == config->batch) ||
+        (config->batch >= config->ringSize) || (0 == mixTotal) || (0.0 >= config->duration))
+    {
+        fprintf(stderr, "%s: inconsistent scenario\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static void scenario_json(FILE *out, const scenario_config_t *config, const scenario_run_t *run, uint64_t elapsedNs,
+                          int first)
+{
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t errors = 0;
+
+    for (int p = 0; p < config->producers; p++)
+    {
+        sent += run->producer[p].sent;
+        received += scenarioReceived[p];
+        errors += scenarioErrors[p];
+    }
+
+    fprintf(out, "%s  {\n", first ? "" : ",\n");
+    fprintf(out, "    \"name\": \"%s\",\n", config->name);
+    fprintf(out,
+            "    \"config\": {\"producers\": %d, \"consumers\": %d, \"ring_size\": %u, \"layout\": \"%s\", "
+            "\"batch\": %u, \"rate\": %.1f, \"duration\": %.3f, \"mix\": {",
+            config->producers, config->consumers, config->ringSize, config->padded ? "padded" : "packed",
+            config->batch, config->rate, config->duration);
+    for (int t = 0; t < SCENARIO_TYPE_COUNT; t++)
+    {
+        fprintf(out, "%s\"%s\": %u", (0 == t) ? "" : ", ", scenarioTypeNames[t], config->mix[t]);
+    }
+    fprintf(out, "}},\n");
+    fprintf(out, "    \"elapsed_s\": %.6f,\n", (double)elapsedNs / 1e9);
+    fprintf(out, "    \"sent\": %llu,\n", (unsigned long long)sent);
+    fprintf(out, "    \"received\": %llu,\n", (unsigned long long)received);
+    fprintf(out, "    \"sequence_errors\": %llu,\n", (unsigned long long)errors);
+    fprintf(out, "    \"msgs_per_s\": %.1f,\n", (double)received * 1e9 / (double)elapsedNs);
+    fprintf(out, "    \"ns_per_msg\": %.3f,\n", (0 != received) ? (double)elapsedNs / (double)received : 0.0);
+    fprintf(out, "    \"producers\": [");
+    for (int p = 0; p < config->producers; p++)
+    {
+        fprintf(out, "%s{\"cpu\": %d, \"sent\": %llu, \"full_waits\": %llu}", (0 == p) ? "" : ", ",
+                run->producer[p].cpu, (unsigned long long)run->producer[p].sent,
+                (unsigned long long)run->producer[p].fullWaits);
+    }
+    fprintf(out, "],\n    \"consumers\": [");
+    for (int c = 0; c < config->consumers; c++)
+    {
+        fprintf(out, "%s{\"cpu\": %d, \"receive_calls\": %llu}", (0 == c) ? "" : ", ", run->consumer[c].cpu,
+                (unsigned long long)run->consumer[c].receiveCalls);
+    }
+    fprintf(out, "]\n  }");
+}
+
+static int scenario_execute(const scenario_config_t *config, FILE *out, int first)
+{
+    scenario_run_t *run = calloc(1, sizeof(*run));
+    int result;
+
+    run->config = config;
+    scenarioRun = run;
+    memset(scenarioExpected, 0, sizeof(scenarioExpected));
+    memset(scenarioReceived, 0, sizeof(scenarioReceived));
+    memset(scenarioErrors, 0, sizeof(scenarioErrors));
+    pthread_barrier_init(&run->start, NULL, (unsigned)(config->producers + config->consumers + 1));
+
+    for (int p = 0; p < config->producers; p++)
+    {
+        run->producer[p].cpu = (0 < config->producerCpuCount) ? config->producerCpus[p % config->producerCpuCount] : -1;
+        MCF_bench_ring_init(&run->producer[p].ring, config->padded, config->ringSize, scenario_parser);
+    }
+    for (int c = 0; c < config->consumers; c++)
+    {
+        run->consumer[c].index = c;
+        run->consumer[c].cpu = (0 < config->consumerCpuCount) ? config->consumerCpus[c % config->consumerCpuCount] : -1;
+        pthread_create(&run->consumer[c].thread, NULL, scenario_consumer, &run->consumer[c]);
+    }
+    for (int p = 0; p < config->producers; p++)
+    {
+        pthread_create(&run->producer[p].thread, NULL, scenario_producer, &run->producer[p]);
+    }
+
+    pthread_barrier_wait(&run->start);
+    run->startNs = MCF_bench_now_ns();
+
+    for (int p = 0; p < config->producers; p++)
+    {
+        pthread_join(run->producer[p].thread, NULL);
+    }
+    run->stop = 1;
+    for (int c = 0; c < config->consumers; c++)
+    {
+        pthread_join(run->consumer[c].thread, NULL);
+    }
+
+    scenario_json(out, config, run, MCF_bench_now_ns() - run->startNs, first);
+
+    result = 0;
+    for (int p = 0; p < config->producers; p++)
+    {
+        if ((0 != scenarioErrors[p]) || (scenarioReceived[p] != run->producer[p].sent))
+        {
+            result = 1;
+        }
+        MCF_bench_ring_free(&run->producer[p].ring);
+    }
+
+    pthread_barrier_destroy(&run->start);
+    free(run);
+    return result;
+}
+
+int MCF_bench_scenario(void)
+{
+    FILE *out = stdout;
+    int result = 0;
+    int first = 1;
+
+    if (0 == benchOptions.scenarioCount)
+    {
+        printf("no scenario files given (--scenario FILE)\n");
+        return 0;
+    }
+
+    if (NULL != benchOptions.outputFile)
+    {
+        out = fopen(benchOptions.outputFile, "w");
+        if (NULL == out)
+        {
+            fprintf(stderr, "cannot write '%s'\n", benchOptions.outputFile);
+            return 1;
+        }
+    }
+
+    fprintf(out, "[\n");
+    for (int i = 0; i < benchOptions.scenarioCount; i++)
+    {
+        scenario_config_t config;
+
+        if (0 != scenario_load(benchOptions.scenarioFiles[i], &config))
+        {
+            result = 1;
+            continue;
+        }
+        result |= scenario_execute(&config, out, first);
+        first = 0;
+    }
+    fprintf(out, "\n]\n");
+
+    if (stdout != out)
+    {
+        fclose(out);
+    }
+    return result;
+}
@@ -0,0 +1,219 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Chaos scheduling stress test of the head/tail protocol.
+ *
+ * Build the library and the harness with -DMCF_ENABLE_CHAOS:
+ *
+ *     cc -O2 -pthread -DMCF_ENABLE_CHAOS -I. MCF*.c bench/MCF_bench*.c -lm -o mcf_stress
+ *     ./mcf_stress -n 4000000000 stress
+ *
+ * MCF then calls MCF_chaos_hook() between writing data and publishing the index
+ * (see MCF_trace.h); the hook below randomly spins, yields, sleeps or migrates the
+ * calling thread to another allowed CPU. Every message carries a sequence number
+ * and a msgID derived from it, so lost, duplicated, reordered or torn messages are
+ * all detected. Small rings are included so wrap-arounds happen constantly.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+/** Mismatches printed in detail before only counting. */
+#define STRESS_REPORT_LIMIT 10u
+
+static const uint16_t stressRingSizes[] = {2, 3, 5, 17, 0};
+
+static _Thread_local uint64_t stressRng;
+static uint64_t stressHookCalls[MCF_CHAOS_SITE_COUNT];
+static cpu_set_t stressAllowed;
+static int stressCpuCount;
+
+static uint32_t stressExpected;
+static uint64_t stressReceived;
+static uint64_t stressErrors;
+
+static inline uint16_t stress_msg_id(uint32_t seq)
+{
+    return (uint16_t)((seq * 2654435761u) >> 16);
+}
+
+static uint64_t stress_random(void)
+{
+    if (0 == stressRng)
+    {
+        stressRng = (MCF_bench_now_ns() ^ (uintptr_t)&stressRng) | 1u;
+    }
+    stressRng ^= stressRng << 13;
+    stressRng ^= stressRng >> 7;
+    stressRng ^= stressRng << 17;
+    return stressRng;
+}
+
+static void stress_migrate(uint64_t r)
+{
+    int target = (int)(r % (uint64_t)stressCpuCount);
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &stressAllowed) && (0 == target--))
+        {
+            MCF_bench_pin(cpu);
+            return;
+        }
+    }
+}
+
+void MCF_chaos_hook(MCF_chaos_site_t site)
+{
+    uint64_t r = stress_random();
+
+    __atomic_fetch_add(&stressHookCalls[site], 1, __ATOMIC_RELAXED);
+
+    if (0 == (r & 0xffffu))
+    {
+        stress_migrate(r >> 16);
+    }
+    else if (0 == (r & 0x1fffu))
+    {
+        struct timespec pause = {.tv_sec = 0, .tv_nsec = (long)(1000u + ((r >> 13) % 100000u))};
+        nanosleep(&pause, NULL);
+    }
+    else if (0 == (r & 0xffu))
+    {
+        sched_yield();
+    }
+    else if (0 == (r & 0xfu))
+    {
+        for (uint64_t spin = (r >> 4) & 0x3ffu; 0 < spin; spin--)
+        {
+            __asm__ volatile("" ::: "memory");
+        }
+    }
+}
+
+static void stress_parser(MCF_Message_t *msgBuf)
+{
+    uint32_t value = msgBuf->u32;
+    uint16_t msgID = msgBuf->msgID;
+
+    if ((value != stressExpected) || (msgID != stress_msg_id(value)))
+    {
+        if (stressErrors < STRESS_REPORT_LIMIT)
+        {
+            fprintf(stderr, "stress: expected seq %u, got seq %u msgID 0x%04x (want 0x%04x)\n", stressExpected, value,
+                    msgID, stress_msg_id(value));
+        }
+        stressErrors++;
+    }
+    stressExpected = value + 1;
+    stressReceived++;
+}
+
+typedef struct
+{
+    MCF_bench_ring_t ring;
+    pthread_barrier_t start;
+    uint32_t messages;
+} stress_run_t;
+
+static void *stress_producer(void *arg)
+{
+    stress_run_t *run = arg;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    for (uint32_t seq = 0; seq < run->messages; seq++)
+    {
+        while (0 == MCF_bench_ring_free_space(&run->ring.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+        MCF_send_u32(&run->ring.tx, stress_msg_id(seq), seq);
+    }
+    return NULL;
+}
+
+static void *stress_consumer(void *arg)
+{
+    stress_run_t *run = arg;
+    uint32_t spins = 0;
+
+    pthread_barrier_wait(&run->start);
+    while (stressReceived < run->messages)
+    {
+        uint64_t before = stressReceived;
+
+        MCF_receive(&run->ring.rx);
+        if (before == stressReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    return NULL;
+}
+
+int MCF_bench_stress(void)
+{
+    int result = 0;
+
+#ifndef MCF_ENABLE_CHAOS
+    printf("built without -DMCF_ENABLE_CHAOS: no delays are injected, only sequences are validated\n");
+#endif
+
+    sched_getaffinity(0, sizeof(stressAllowed), &stressAllowed);
+    stressCpuCount = CPU_COUNT(&stressAllowed);
+
+    printf("%8s %12s %10s %12s %12s %12s %12s %8s\n", "ring", "messages", "seconds", "send hooks", "advance",
+           "wrap", "parse", "errors");
+
+    for (size_t i = 0; i < sizeof(stressRingSizes) / sizeof(stressRingSizes[0]); i++)
+    {
+        stress_run_t run = {.messages = benchOptions.messages};
+        uint16_t size = (0 != stressRingSizes[i]) ? stressRingSizes[i] : benchOptions.ringSize;
+        pthread_t producer;
+        pthread_t consumer;
+
+        stressExpected = 0;
+        stressReceived = 0;
+        stressErrors = 0;
+        for (int site = 0; site < MCF_CHAOS_SITE_COUNT; site++)
+        {
+            stressHookCalls[site] = 0;
+        }
+
+        MCF_bench_ring_init(&run.ring, 1, size, stress_parser);
+        pthread_barrier_init(&run.start, NULL, 2);
+
+        uint64_t startNs = MCF_bench_now_ns();
+        pthread_create(&consumer, NULL, stress_consumer, &run);
+        pthread_create(&producer, NULL, stress_producer, &run);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+        uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+        printf("%8u %12llu %10.2f %12llu %12llu %12llu %12llu %8llu\n", size, (unsigned long long)stressReceived,
+               (double)elapsedNs / 1e9, (unsigned long long)stressHookCalls[MCF_CHAOS_SEND_PUBLISH],
+               (unsigned long long)stressHookCalls[MCF_CHAOS_RECEIVE_ADVANCE],
+               (unsigned long long)stressHookCalls[MCF_CHAOS_RECEIVE_WRAP],
+               (unsigned long long)stressHookCalls[MCF_CHAOS_RECEIVE_PARSE], (unsigned long long)stressErrors);
+
+        pthread_barrier_destroy(&run.start);
+        MCF_bench_ring_free(&run.ring);
+        result |= (0 != stressErrors);
+    }
+
+    return result;
+}
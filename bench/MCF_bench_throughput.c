@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+#include "MCF_bench.h"
+#include <pthread.h>
+#include <stdio.h>
+
+/**
+ * @brief One throughput scenario: control block layout and producer burst size.
+ */
+typedef struct
+{
+    const char *name;
+    int padded;
+    uint16_t batch;
+} MCF_bench_throughput_scenario_t;
+
+static const MCF_bench_throughput_scenario_t throughputScenarios[] = {
+    {"packed  batch=1", 0, 1},   {"padded  batch=1", 1, 1},   {"packed  batch=16", 0, 16},
+    {"padded  batch=16", 1, 16}, {"packed  batch=64", 0, 64}, {"padded  batch=64", 1, 64},
+};
+
+/**
+ * @brief State shared by the producer and consumer threads of a run.
+ */
+typedef struct
+{
+    MCF_bench_ring_t ring;
+    uint16_t batch;
+    pthread_barrier_t start;
+    uint64_t startNs;
+    uint64_t endNs;
+    MCF_perf_t perf[2];
+} MCF_bench_throughput_run_t;
+
+static uint32_t throughputReceived;
+static uint32_t throughputErrors;
+
+static void throughput_parser(MCF_Message_t *msgBuf)
+{
+    if (msgBuf->u32 != throughputReceived)
+    {
+        throughputErrors++;
+    }
+    throughputReceived++;
+}
+
+static void *throughput_producer(void *arg)
+{
+    MCF_bench_throughput_run_t *run = arg;
+    uint32_t total = benchOptions.messages;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    MCF_perf_open(&run->perf[0]);
+    pthread_barrier_wait(&run->start);
+
+    run->startNs = MCF_bench_now_ns();
+    MCF_perf_start(&run->perf[0]);
+
+    for (uint32_t seq = 0; seq < total;)
+    {
+        uint32_t burst = (total - seq < run->batch) ? (total - seq) : run->batch;
+
+        while (MCF_bench_ring_free_space(&run->ring.tx) < burst)
+        {
+            MCF_bench_relax(&spins);
+        }
+
+        for (uint32_t i = 0; i < burst; i++, seq++)
+        {
+            MCF_send_u32(&run->ring.tx, 1, seq);
+        }
+    }
+
+    MCF_perf_stop(&run->perf[0]);
+    MCF_perf_close(&run->perf[0]);
+    return NULL;
+}
+
+static void *throughput_consumer(void *arg)
+{
+    MCF_bench_throughput_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    MCF_perf_open(&run->perf[1]);
+    pthread_barrier_wait(&run->start);
+
+    MCF_perf_start(&run->perf[1]);
+
+    while (throughputReceived < benchOptions.messages)
+    {
+        uint32_t before = throughputReceived;
+
+        MCF_receive(&run->ring.rx);
+        if (before == throughputReceived)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+
+    MCF_perf_stop(&run->perf[1]);
+    run->endNs = MCF_bench_now_ns();
+    MCF_perf_close(&run->perf[1]);
+    return NULL;
+}
+
+int MCF_bench_throughput(void)
+{
+    int result = 0;
+
+    printf("%-20s %10s", "scenario", "ns/msg");
+    MCF_bench_print_counters_header();
+    printf("\n");
+
+    for (size_t i = 0; i < sizeof(throughputScenarios) / sizeof(throughputScenarios[0]); i++)
+    {
+        const MCF_bench_throughput_scenario_t *scenario = &throughputScenarios[i];
+        MCF_bench_throughput_run_t run = {.batch = scenario->batch};
+        MCF_perf_t total = {.available = ~0u};
+        pthread_t producer;
+        pthread_t consumer;
+
+        if (scenario->batch >= benchOptions.ringSize)
+        {
+            continue;
+        }
+
+        throughputReceived = 0;
+        throughputErrors = 0;
+        MCF_bench_ring_init(&run.ring, scenario->padded, benchOptions.ringSize, throughput_parser);
+        pthread_barrier_init(&run.start, NULL, 2);
+
+        pthread_create(&consumer, NULL, throughput_consumer, &run);
+        pthread_create(&producer, NULL, throughput_producer, &run);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+
+        MCF_perf_merge(&total, &run.perf[0]);
+        MCF_perf_merge(&total, &run.perf[1]);
+
+        printf("%-20s %10.2f", scenario->name, (double)(run.endNs - run.startNs) / (double)benchOptions.messages);
+        MCF_bench_print_counters(&total, benchOptions.messages);
+        printf("\n");
+
+        if (0 != throughputErrors)
+        {
+            fprintf(stderr, "%s: %u out-of-order messages\n", scenario->name, throughputErrors);
+            result = 1;
+        }
+
+        pthread_barrier_destroy(&run.start);
+        MCF_bench_ring_free(&run.ring);
+    }
+
+    return result;
+}
@@ -0,0 +1,347 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * A consumer persisting or forwarding its ring, synchronously or through
+ * MCF_uring:
+ *
+ *     write-file     MCF_peek() + write() + MCF_release(), blocking
+ *     uring-file     MCF_uring in positioned mode, up to MCF_URING_DEPTH writes in flight
+ *     write-stream   as write-file, into an AF_UNIX stream socket
+ *     uring-stream   MCF_uring in stream mode, into the same kind of socket
+ *
+ * The producer sends a counter. The file is read back afterwards and the socket
+ * is drained by a reader thread; both must hold the exact sequence. "sink ns/msg"
+ * is the time the consumer spent inside write() or MCF_uring_poll(), i.e. what
+ * the sink costs the consumer thread.
+ */
+
+#define _GNU_SOURCE
+#include "MCF_bench.h"
+#include "MCF_uring.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Messages per run (8 bytes each). */
+#define URING_MAX_MESSAGES 2000000u
+
+typedef enum
+{
+    URING_WRITE_FILE = 0,
+    URING_URING_FILE,
+    URING_WRITE_STREAM,
+    URING_URING_STREAM,
+    URING_VARIANT_COUNT
+} uring_variant_t;
+
+static const char *const uringVariantNames[URING_VARIANT_COUNT] = {"write-file", "uring-file", "write-stream",
+                                                                    "uring-stream"};
+
+typedef struct
+{
+    uring_variant_t variant;
+    uint32_t messages;
+    MCF_bench_ring_t ring;
+    int fd;
+    int peerFd;
+    pthread_barrier_t start;
+    uint64_t sinkNs;
+    uint64_t reads;
+    uint64_t errors;
+    uint64_t shortWrites;
+    uint8_t registered;
+} uring_run_t;
+
+/**
+ * @brief Checks a byte stream of counter messages; returns the number of messages checked.
+ */
+static uint32_t uring_check(const uint8_t *bytes, size_t length, uint32_t next, uint64_t *errors)
+{
+    for (size_t i = 0; i + sizeof(MCF_Message_t) <= length; i += sizeof(MCF_Message_t))
+    {
+        MCF_Message_t msg;
+
+        memcpy(&msg, bytes + i, sizeof(msg));
+        *errors += (msg.u32 != next);
+        next++;
+    }
+    return next;
+}
+
+/** The sink consumes with MCF_peek()/MCF_release() and never parses. */
+static void uring_unused_parser(MCF_Message_t *msgBuf)
+{
+    (void)msgBuf;
+}
+
+static void *uring_producer(void *arg)
+{
+    uring_run_t *run = arg;
+    uint32_t spins = 0;
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    pthread_barrier_wait(&run->start);
+    for (uint32_t i = 0; i < run->messages; i++)
+    {
+        while (0u == MCF_get_free(&run->ring.tx))
+        {
+            MCF_bench_relax(&spins);
+        }
+        MCF_send_u32(&run->ring.tx, 1, i);
+    }
+    return NULL;
+}
+
+static void *uring_reader(void *arg)
+{
+    uring_run_t *run = arg;
+    uint8_t buffer[65536 + sizeof(MCF_Message_t)];
+    size_t carry = 0;
+    uint32_t next = 0;
+
+    while (next < run->messages)
+    {
+        ssize_t length = read(run->peerFd, buffer + carry, sizeof(buffer) - carry);
+
+        if (0 >= length)
+        {
+            break;
+        }
+        run->reads++;
+        length += (ssize_t)carry;
+        next = uring_check(buffer, (size_t)length, next, &run->errors);
+        carry = (size_t)length % sizeof(MCF_Message_t);
+        memmove(buffer, buffer + (size_t)length - carry, carry);
+    }
+    run->errors += run->messages - next;
+    return NULL;
+}
+
+/**
+ * @brief Drains the ring with blocking write() calls; returns 0 on success.
+ */
+static int uring_consume_write(uring_run_t *run)
+{
+    uint32_t written = 0;
+    uint32_t spins = 0;
+
+    while (written < run->messages)
+    {
+        MCF_Message_t *span;
+        uint16_t count = MCF_peek(&run->ring.rx, 0, &span);
+
+        if (0u == count)
+        {
+            MCF_bench_relax(&spins);
+            continue;
+        }
+
+        uint64_t startNs = MCF_bench_now_ns();
+        const uint8_t *data = (const uint8_t *)span;
+        size_t bytes = count * sizeof(MCF_Message_t);
+        while (0u < bytes)
+        {
+            ssize_t result = write(run->fd, data, bytes);
+            if (0 > result)
+            {
+                perror("write");
+                return -1;
+            }
+            data += result;
+            bytes -= (size_t)result;
+        }
+        run->sinkNs += MCF_bench_now_ns() - startNs;
+        MCF_release(&run->ring.rx, count);
+        written += count;
+    }
+    return 0;
+}
+
+/**
+ * @brief Drains the ring through MCF_uring; returns 0 on success, 1 if io_uring is unavailable.
+ */
+static int uring_consume_uring(uring_run_t *run, int64_t fileOffset)
+{
+    MCF_Uring_t sink;
+    uint32_t spins = 0;
+    int status = MCF_uring_init(&sink, &run->ring.rx, run->fd, fileOffset);
+
+    if (0 != status)
+    {
+        printf("%-14s io_uring unavailable: %s\n", uringVariantNames[run->variant], strerror(-status));
+        /* Still drain the ring so the producer can finish. */
+        (void)uring_consume_write(run);
+        return 1;
+    }
+    run->registered = sink.registered;
+
+    while (sink.messages < run->messages)
+    {
+        uint64_t startNs = MCF_bench_now_ns();
+        int released = MCF_uring_poll(&sink);
+        run->sinkNs += MCF_bench_now_ns() - startNs;
+
+        if (0 > released)
+        {
+            fprintf(stderr, "uring: %s\n", strerror(sink.error));
+            status = -1;
+            break;
+        }
+        if (0 == released)
+        {
+            MCF_bench_relax(&spins);
+        }
+    }
+    if ((0 == status) && (0 != MCF_uring_flush(&sink)))
+    {
+        status = -1;
+    }
+    run->shortWrites = sink.shortWrites;
+    MCF_uring_deinit(&sink);
+    return status;
+}
+
+static void *uring_consumer(void *arg)
+{
+    uring_run_t *run = arg;
+    int status;
+
+    MCF_bench_pin(benchOptions.cpuConsumer);
+    pthread_barrier_wait(&run->start);
+    switch (run->variant) {
+    case URING_URING_FILE:
+        status = uring_consume_uring(run, 0);
+        break;
+    case URING_URING_STREAM:
+        status = uring_consume_uring(run, MCF_URING_STREAM);
+        break;
+    default:
+        status = uring_consume_write(run);
+        break;
+    }
+    if (0 > status)
+    {
+        run->errors++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reads the file back and checks the sequence.
+ */
+static void uring_verify_file(uring_run_t *run)
+{
+    size_t length = (size_t)run->messages * sizeof(MCF_Message_t);
+    uint8_t *bytes = malloc(length);
+    ssize_t result = pread(run->fd, bytes, length, 0);
+
+    if ((ssize_t)length != result)
+    {
+        run->errors++;
+    }
+    else if (run->messages != uring_check(bytes, length, 0, &run->errors))
+    {
+        run->errors++;
+    }
+    free(bytes);
+}
+
+int MCF_bench_uring(void)
+{
+    uint32_t messages = (benchOptions.messages < URING_MAX_MESSAGES) ? benchOptions.messages : URING_MAX_MESSAGES;
+    int result = 0;
+
+    printf("%u messages per sink, MCF_URING_DEPTH %u\n", messages, MCF_URING_DEPTH);
+    printf("%-14s %10s %12s %10s %12s %8s\n", "sink", "Mmsg/s", "sink ns/msg", "fixed buf", "short writes",
+           "errors");
+
+    for (int variant = 0; variant < URING_VARIANT_COUNT; variant++)
+    {
+        uring_run_t *run = calloc(1, sizeof(*run));
+        int stream = (URING_WRITE_STREAM == variant) || (URING_URING_STREAM == variant);
+        pthread_t producer;
+        pthread_t consumer;
+        pthread_t reader;
+
+        run->variant = (uring_variant_t)variant;
+        run->messages = messages;
+        run->peerFd = -1;
+        if (stream)
+        {
+            int fds[2];
+
+            if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+            {
+                perror("socketpair");
+                free(run);
+                result = 1;
+                continue;
+            }
+            run->fd = fds[0];
+            run->peerFd = fds[1];
+        }
+        else
+        {
+            char path[] = "/tmp/mcf_bench_uringXXXXXX";
+
+            run->fd = mkstemp(path);
+            if (0 > run->fd)
+            {
+                perror("mkstemp");
+                free(run);
+                result = 1;
+                continue;
+            }
+            unlink(path);
+        }
+        MCF_bench_ring_init(&run->ring, 1, benchOptions.ringSize, uring_unused_parser);
+        pthread_barrier_init(&run->start, NULL, 2);
+
+        uint64_t startNs = MCF_bench_now_ns();
+        if (stream)
+        {
+            pthread_create(&reader, NULL, uring_reader, run);
+        }
+        pthread_create(&consumer, NULL, uring_consumer, run);
+        pthread_create(&producer, NULL, uring_producer, run);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+        if (stream)
+        {
+            pthread_join(reader, NULL);
+        }
+        uint64_t elapsedNs = MCF_bench_now_ns() - startNs;
+
+        if (!stream)
+        {
+            uring_verify_file(run);
+        }
+        printf("%-14s %10.3f %12.2f %10s %12llu %8llu\n", uringVariantNames[variant],
+               (double)messages * 1e3 / (double)elapsedNs, (double)run->sinkNs / (double)messages,
+               run->registered ? "yes" : "no", (unsigned long long)run->shortWrites,
+               (unsigned long long)run->errors);
+        result |= (0u != run->errors);
+
+        pthread_barrier_destroy(&run->start);
+        close(run->fd);
+        if (0 <= run->peerFd)
+        {
+            close(run->peerFd);
+        }
+        MCF_bench_ring_free(&run->ring);
+        free(run);
+    }
+
+    return result;
+}
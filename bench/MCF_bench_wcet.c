@@ -0,0 +1,213 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Author: Adrian Pietrzak
+ * GitHub: https://github.com/AdrianPietrzak1998
+ * Created: May 20, 2025
+ */
+
+/*
+ * Worst-case execution time characterisation of MCF_send_* and MCF_receive.
+ *
+ * Each scenario drives a freshly initialized ring into an adversarial state
+ * (index about to wrap, last free slot, overrun, maximum backlog, backlog across
+ * the wrap), optionally evicts the ring and its control block from the caches,
+ * and times a single call. Trials are repeated and the worst observed time per
+ * call and per message is reported for the packed and padded control blocks.
+ *
+ * The figures are measured maxima, not a static bound; use them with --isolate
+ * and --noise to compare configurations on their worst case.
+ */
+
+#include "MCF_bench.h"
+#include "MCF_bench_hist.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Trials per scenario and cache state. */
+#define WCET_TRIALS 10000u
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(MCF_bench_ring_t *ring);
+    int send;
+    uint16_t (*messages)(void);
+} wcet_scenario_t;
+
+static uint32_t wcetReceived;
+
+static void wcet_parser(MCF_Message_t *msgBuf)
+{
+    wcetReceived += msgBuf->msgID;
+}
+
+static void wcet_fill(MCF_bench_ring_t *ring, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        MCF_send_u32(&ring->tx, 1, i);
+    }
+}
+
+static void wcet_setup_empty(MCF_bench_ring_t *ring)
+{
+    (void)ring;
+}
+
+/* Head and tail at the last slot: the next send takes the wrap branch. */
+static void wcet_setup_wrap(MCF_bench_ring_t *ring)
+{
+    wcet_fill(ring, benchOptions.ringSize - 1u);
+    MCF_receive(&ring->rx);
+}
+
+/* One free slot left: the send fills the ring. */
+static void wcet_setup_last_slot(MCF_bench_ring_t *ring)
+{
+    wcet_fill(ring, benchOptions.ringSize - 2u);
+}
+
+/* Ring full: MCF does not refuse, the send overruns the consumer. */
+static void wcet_setup_full(MCF_bench_ring_t *ring)
+{
+    wcet_fill(ring, benchOptions.ringSize - 1u);
+}
+
+static void wcet_setup_one(MCF_bench_ring_t *ring)
+{
+    wcet_fill(ring, 1);
+}
+
+/* Backlog starting mid-ring, so the drain crosses the wrap boundary. */
+static void wcet_setup_backlog_wrap(MCF_bench_ring_t *ring)
+{
+    wcet_fill(ring, benchOptions.ringSize / 2u);
+    MCF_receive(&ring->rx);
+    wcet_fill(ring, benchOptions.ringSize - 1u);
+}
+
+static uint16_t wcet_one(void)
+{
+    return 1;
+}
+
+static uint16_t wcet_backlog(void)
+{
+    return benchOptions.ringSize - 1u;
+}
+
+static const wcet_scenario_t wcetScenarios[] = {
+    {"send empty", wcet_setup_empty, 1, wcet_one},
+    {"send wrap", wcet_setup_wrap, 1, wcet_one},
+    {"send last slot", wcet_setup_last_slot, 1, wcet_one},
+    {"send full", wcet_setup_full, 1, wcet_one},
+    {"receive 1", wcet_setup_one, 0, wcet_one},
+    {"receive backlog", wcet_setup_full, 0, wcet_backlog},
+    {"receive wrapped", wcet_setup_backlog_wrap, 0, wcet_backlog},
+};
+
+/** Evicts `size` bytes at `addr` from every cache level. */
+static void wcet_flush(const void *addr, size_t size)
+{
+    const char *p = addr;
+
+    for (size_t offset = 0; offset < size; offset += MCF_BENCH_CACHE_LINE)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_clflush(p + offset);
+#elif defined(__aarch64__)
+        __asm__ volatile("dc civac, %0" ::"r"(p + offset) : "memory");
+#else
+        (void)p;
+#endif
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_mfence();
+#elif defined(__aarch64__)
+    __asm__ volatile("dsb ish" ::: "memory");
+#endif
+}
+
+static void wcet_make_cold(MCF_bench_ring_t *ring, int padded)
+{
+    wcet_flush(ring->msgBuf, (size_t)benchOptions.ringSize * sizeof(MCF_Message_t));
+    wcet_flush(ring->ctrl, padded ? sizeof(MCF_bench_ctrl_padded_t) : sizeof(MCF_bench_ctrl_packed_t));
+    wcet_flush(ring, sizeof(*ring));
+}
+
+static void wcet_run(const wcet_scenario_t *scenario, int padded, int cold, MCF_hist_t *hist)
+{
+    MCF_bench_ring_t ring;
+
+    MCF_bench_ring_init(&ring, padded, benchOptions.ringSize, wcet_parser);
+    MCF_hist_reset(hist);
+
+    for (uint32_t trial = 0; trial < WCET_TRIALS; trial++)
+    {
+        uint64_t t0;
+        uint64_t t1;
+
+        MCF_init_RXTX(&ring.rx, ring.rx.head, ring.rx.tail, ring.msgBuf, benchOptions.ringSize, wcet_parser);
+        scenario->setup(&ring);
+        if (cold)
+        {
+            wcet_make_cold(&ring, padded);
+        }
+
+        if (scenario->send)
+        {
+            t0 = MCF_bench_ticks();
+            MCF_send_u32(&ring.tx, 1, trial);
+            t1 = MCF_bench_ticks();
+        }
+        else
+        {
+            t0 = MCF_bench_ticks();
+            MCF_receive(&ring.rx);
+            t1 = MCF_bench_ticks();
+        }
+        MCF_hist_record(hist, t1 - t0);
+    }
+
+    MCF_bench_ring_free(&ring);
+}
+
+int MCF_bench_wcet(void)
+{
+    MCF_hist_t *hist = malloc(sizeof(*hist));
+    double ticksPerNs = MCF_bench_ticks_per_ns();
+
+    MCF_bench_pin(benchOptions.cpuProducer);
+    MCF_bench_isolate();
+    MCF_bench_noise_start();
+
+    printf("ring %u messages, %u trials, noise threads %d, isolate %s\n", benchOptions.ringSize, WCET_TRIALS,
+           benchOptions.noiseThreads, benchOptions.isolate ? "on" : "off");
+    printf("%-16s %-7s %-5s %8s %12s %12s %12s %12s\n", "scenario", "ctrl", "cache", "msgs", "mean ns", "p99.99 ns",
+           "wcet ns", "wcet ns/msg");
+
+    for (size_t i = 0; i < sizeof(wcetScenarios) / sizeof(wcetScenarios[0]); i++)
+    {
+        for (int padded = 0; padded <= 1; padded++)
+        {
+            for (int cold = 0; cold <= 1; cold++)
+            {
+                const wcet_scenario_t *scenario = &wcetScenarios[i];
+                uint16_t messages = scenario->messages();
+
+                wcet_run(scenario, padded, cold, hist);
+                printf("%-16s %-7s %-5s %8u %12.1f %12.1f %12.1f %12.2f\n", scenario->name,
+                       padded ? "padded" : "packed", cold ? "cold" : "warm", messages,
+                       MCF_hist_mean(hist) / ticksPerNs, (double)MCF_hist_percentile(hist, 99.99) / ticksPerNs,
+                       (double)hist->max / ticksPerNs, (double)hist->max / ticksPerNs / (double)messages);
+            }
+        }
+    }
+
+    MCF_bench_noise_stop();
+    free(hist);
+    return 0;
+}